@@ -0,0 +1,201 @@
+// EventLog.h
+#pragma once
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "Robot.h"
+#include "Simulation.h"
+
+enum class LogLevel { Off, Removals, All };
+
+// One tick event as stored in the log's ring buffer: fixed size, with the
+// name copied inline. A name longer than kNameBytes is kept whole out of
+// line instead (nameLen == kLongName), in a string the log keeps per slot.
+struct TurnEvent {
+    static constexpr std::size_t kNameBytes = 40;
+    static constexpr std::uint8_t kLongName = 0xFF;
+
+    std::int32_t before;
+    std::int32_t after;
+    std::uint8_t what;              // TurnResult
+    std::uint8_t nameLen;
+    char name[kNameBytes];
+};
+
+namespace eventlog {
+inline void appendInt(std::string& out, int v) {
+    char buf[12];
+    auto r = std::to_chars(buf, buf + sizeof buf, v);
+    out.append(buf, r.ptr);
+}
+
+// Same text as formatTurn(); longName is the event's out-of-line name
+inline void format(std::string& out, const TurnEvent& e, std::string_view longName) {
+    std::string_view name = e.nameLen == TurnEvent::kLongName ? longName : std::string_view(e.name, e.nameLen);
+    if (e.what == static_cast<std::uint8_t>(TurnResult::Skipped)) {
+        out += "Skipped (paused): Robot(";
+        out += name;
+        out += ", Battery=";
+        appendInt(out, e.before);
+        out += ")\n";
+        return;
+    }
+    out += "Tick: ";
+    out += name;
+    out += " battery ";
+    appendInt(out, e.before);
+    out += " -> ";
+    appendInt(out, e.after);
+    out += "\n";
+    if (e.what == static_cast<std::uint8_t>(TurnResult::Removed)) {
+        out += "Removed: Robot(";
+        out += name;
+        out += ", Battery=";
+        appendInt(out, e.after);
+        out += ") (returned to dock)\n";
+    }
+}
+} // namespace eventlog
+
+// Tick event sink for runTurns (see StreamSink) that keeps formatting and
+// I/O off the simulation thread. record() copies the event into a
+// preallocated single-producer ring buffer (no locks, and no allocation
+// unless a name is longer than any the slot has held before); a
+// background thread formats events and writes them to the stream in large
+// chunks. With LogLevel::Off nothing is recorded and runTurns keeps its
+// fast paths; LogLevel::Removals records removals only.
+//
+// record()/flush()/setLevel() belong to one thread (the simulation
+// thread). Nothing else may write to the stream until flush() returns.
+// When the buffer is full, record() waits for the formatter (Overflow::Block,
+// output stays exact) or drops the event and counts it (Overflow::Drop).
+class EventLog {
+public:
+    enum class Overflow { Block, Drop };
+
+private:
+    static constexpr std::size_t kChunk = 64 * 1024;    // bytes per write
+    static constexpr std::size_t kWakeEvery = 1024;     // events between wakeups
+
+    std::ostream& out_;
+    LogLevel level_;
+    Overflow overflow_;
+    std::vector<TurnEvent> events_; // power-of-two capacity
+    std::vector<std::string> longNames_;  // per slot: names past kNameBytes
+    std::size_t mask_;
+    std::size_t tailSeen_ = 0;      // producer's cached copy of tail_
+    std::size_t dropped_ = 0;
+
+    alignas(64) std::atomic<std::size_t> head_{0};     // next slot to fill
+    alignas(64) std::atomic<std::size_t> tail_{0};     // next slot to format
+
+    std::mutex m_;
+    std::condition_variable wake_;
+    std::condition_variable written_;
+    std::size_t done_ = 0;          // events formatted and written (under m_)
+    bool stop_ = false;
+    std::thread worker_;
+
+    void work() {
+        std::string chunk;
+        chunk.reserve(kChunk + 512);
+        std::size_t t = 0;
+        for (;;) {
+            const std::size_t h = head_.load(std::memory_order_acquire);
+            for (; t != h; ++t) {
+                eventlog::format(chunk, events_[t & mask_], longNames_[t & mask_]);
+                tail_.store(t + 1, std::memory_order_release);
+                if (chunk.size() >= kChunk) {
+                    out_.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+                    chunk.clear();
+                }
+            }
+            if (!chunk.empty()) {
+                out_.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+                chunk.clear();
+            }
+            std::unique_lock<std::mutex> lock(m_);
+            done_ = t;
+            written_.notify_all();
+            if (head_.load(std::memory_order_acquire) != t) continue;
+            if (stop_) return;
+            wake_.wait_for(lock, std::chrono::milliseconds(5));
+        }
+    }
+
+    void wakeWorker() { wake_.notify_one(); }
+
+public:
+    explicit EventLog(std::ostream& out, LogLevel level = LogLevel::All,
+                      std::size_t capacity = 1 << 16, Overflow overflow = Overflow::Block)
+        : out_(out), level_(level), overflow_(overflow) {
+        std::size_t cap = 1;
+        while (cap < capacity) cap *= 2;
+        events_.resize(cap);
+        longNames_.resize(cap);
+        mask_ = cap - 1;
+        worker_ = std::thread([this] { work(); });
+    }
+    ~EventLog() {
+        { std::lock_guard<std::mutex> lock(m_); stop_ = true; }
+        wake_.notify_one();
+        worker_.join();
+        out_.flush();
+    }
+    EventLog(const EventLog&) = delete;
+    EventLog& operator=(const EventLog&) = delete;
+
+    LogLevel level() const { return level_; }
+    void setLevel(LogLevel level) { level_ = level; }
+    std::size_t dropped() const { return dropped_; }
+
+    // Sink interface (runTurns)
+    bool wantsTicks() const { return level_ == LogLevel::All; }
+    bool wantsRemovals() const { return level_ != LogLevel::Off; }
+
+    void record(TurnResult what, const Robot& r, int before) {
+        const std::size_t h = head_.load(std::memory_order_relaxed);
+        if (h - tailSeen_ == events_.size()) {
+            tailSeen_ = tail_.load(std::memory_order_acquire);
+            while (h - tailSeen_ == events_.size()) {
+                if (overflow_ == Overflow::Drop) { ++dropped_; return; }
+                wakeWorker();
+                std::this_thread::yield();
+                tailSeen_ = tail_.load(std::memory_order_acquire);
+            }
+        }
+        TurnEvent& e = events_[h & mask_];
+        std::string_view name = robotName(r);
+        if (name.size() <= TurnEvent::kNameBytes) {
+            e.nameLen = static_cast<std::uint8_t>(name.size());
+            if (e.nameLen) std::memcpy(e.name, name.data(), e.nameLen);
+        } else {
+            e.nameLen = TurnEvent::kLongName;
+            longNames_[h & mask_].assign(name.data(), name.size());  // reuses the slot's capacity
+        }
+        e.before = before;
+        e.after = r.battery;
+        e.what = static_cast<std::uint8_t>(what);
+        head_.store(h + 1, std::memory_order_release);
+        if ((h & (kWakeEvery - 1)) == 0) wakeWorker();
+    }
+
+    // Wait until every recorded event is written, then flush the stream
+    void flush() {
+        const std::size_t h = head_.load(std::memory_order_relaxed);
+        std::unique_lock<std::mutex> lock(m_);
+        wake_.notify_one();
+        written_.wait(lock, [&] { return done_ == h; });
+        out_.flush();
+    }
+};
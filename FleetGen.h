@@ -0,0 +1,226 @@
+// FleetGen.h
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "FleetIO.h"
+#include "Robot.h"
+#include "Simulation.h"
+
+// Seeded fleet generator for benchmarks and load tests. The random stream
+// (splitmix64) and the distributions are all defined here rather than taken
+// from <random>, whose distributions differ between standard libraries, so
+// a seed gives the same fleet on every platform and compiler.
+class FleetRng {
+private:
+    std::uint64_t s_;
+
+public:
+    explicit FleetRng(std::uint64_t seed) : s_(seed) {}
+
+    std::uint64_t next() {
+        std::uint64_t z = (s_ += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // [0, 1)
+    double unit() { return static_cast<double>(next() >> 11) * 0x1.0p-53; }
+
+    // Uniform in [lo, hi] without modulo bias
+    long long between(long long lo, long long hi) {
+        const std::uint64_t span = static_cast<std::uint64_t>(hi - lo) + 1;
+        if (span == 0) return static_cast<long long>(next());   // the full 64-bit range
+        const std::uint64_t limit = ~std::uint64_t(0) - ~std::uint64_t(0) % span;
+        std::uint64_t x;
+        do x = next(); while (x >= limit);
+        return lo + static_cast<long long>(x % span);
+    }
+};
+
+// A distribution of ints over [lo, hi]:
+//  - Uniform: every value equally likely;
+//  - Zipf: value lo + k - 1 with P(k) ~ 1/k^s for rank k, so lo is the most
+//    common and a long tail reaches hi (a bounded power law sampled by
+//    inversion and floored; s defaults to 1);
+//  - Bimodal: two bands, each a tenth of the range wide, at lo and at hi;
+//    pct percent of draws land in the high band (default 50).
+struct FleetDist {
+    enum Kind { Uniform, Zipf, Bimodal };
+    Kind kind = Uniform;
+    int lo = 100, hi = 100;
+    double param = 0;               // Zipf exponent or bimodal high-band percent
+
+    static FleetDist uniform(int lo, int hi) { return {Uniform, lo, hi, 0}; }
+    static FleetDist zipf(int lo, int hi, double s = 1.0) { return {Zipf, lo, hi, s}; }
+    static FleetDist bimodal(int lo, int hi, double pct = 50) { return {Bimodal, lo, hi, pct}; }
+
+    int draw(FleetRng& rng) const {
+        if (kind == Uniform || hi <= lo) return static_cast<int>(rng.between(lo, hi));
+        if (kind == Bimodal) {
+            const int w = (hi - lo) / 10;
+            return rng.unit() * 100 < param ? static_cast<int>(rng.between(hi - w, hi))
+                                            : static_cast<int>(rng.between(lo, lo + w));
+        }
+        // ranks [1, n] from the density x^-s on [1, n + 1)
+        const double n = static_cast<double>(hi) - lo + 1, u = rng.unit();
+        const double x = std::fabs(param - 1) < 1e-9
+                             ? std::exp(u * std::log(n + 1))
+                             : std::pow(1 + u * (std::pow(n + 1, 1 - param) - 1), 1 / (1 - param));
+        const long long k = std::min(static_cast<long long>(x), static_cast<long long>(n));
+        return lo + static_cast<int>(k < 1 ? 0 : k - 1);
+    }
+};
+
+// "LO[:HI]" or "uniform:LO:HI" | "zipf:LO:HI[:S]" | "bimodal:LO:HI[:PCT]".
+// false (and d untouched) on anything else.
+inline bool parseFleetDist(const std::string& text, FleetDist& d) {
+    FleetDist out;
+    std::string rest = text;
+    const std::size_t colon = text.find(':');
+    const std::string head = text.substr(0, colon);
+    if (head == "uniform" || head == "zipf" || head == "bimodal") {
+        if (colon == std::string::npos) return false;
+        out.kind = head == "zipf" ? FleetDist::Zipf : head == "bimodal" ? FleetDist::Bimodal : FleetDist::Uniform;
+        out.param = head == "zipf" ? 1.0 : 50.0;
+        rest = text.substr(colon + 1);
+    }
+    const char* p = rest.c_str();
+    const char* end = p + rest.size();
+    if (!fleetio::parseInt(p, end, out.lo)) return false;
+    out.hi = out.lo;
+    if (p < end && (*p++ != ':' || !fleetio::parseInt(p, end, out.hi))) return false;
+    if (p < end) {
+        if (out.kind == FleetDist::Uniform || *p++ != ':') return false;
+        char* stop = nullptr;
+        out.param = std::strtod(p, &stop);
+        if (stop != end || out.param < 0) return false;
+        if (out.kind == FleetDist::Bimodal && out.param > 100) return false;
+    } else if (out.kind != FleetDist::Uniform && rest.find(':') == std::string::npos) {
+        return false;                           // zipf/bimodal need both ends
+    }
+    if (out.hi < out.lo) return false;
+    d = out;
+    return true;
+}
+
+struct FleetSpec {
+    std::size_t robots = 1000;
+    FleetDist battery = FleetDist::uniform(100, 100);
+    FleetDist drain = FleetDist::uniform(1, 1);
+    int pausedPct = 0;
+    std::uint64_t seed = 1;
+};
+
+// spec.robots robots with ids from nextId on, named R<id>. Each robot draws
+// its battery, drain and paused flag, in that order, from one stream.
+inline std::vector<Robot> generateFleet(const FleetSpec& spec, int& nextId) {
+    FleetRng rng(spec.seed);
+    std::vector<Robot> fleet;
+    fleet.reserve(spec.robots);
+    for (std::size_t i = 0; i < spec.robots; ++i) {
+        const int battery = spec.battery.draw(rng);
+        const int drain = spec.drain.draw(rng);
+        const bool paused = rng.between(0, 99) < spec.pausedPct;
+        fleet.emplace_back(nextId, Robot::NameArg("R" + std::to_string(nextId)), battery, drain, paused);
+        ++nextId;
+    }
+    return fleet;
+}
+
+// Generate straight into a ring (RobotRing or a bare engine)
+template <typename Ring>
+void buildFleet(Ring& ring, const FleetSpec& spec, int& nextId) {
+    std::vector<Robot> fleet = generateFleet(spec, nextId);
+    ring.reserve(fleet.size());
+    ring.append_range(std::make_move_iterator(fleet.begin()), std::make_move_iterator(fleet.end()));
+}
+
+// ---- load-test scenarios ----
+
+// Canned end-to-end loads for catching regressions across engines:
+//  - mass-removal: batteries 1..8, so robots retire every few ticks and the
+//    ring drains to empty;
+//  - mostly-paused: 90% of the fleet paused, Zipf batteries, drains 1..3;
+//  - split-merge: bimodal batteries; the ring is split in two, each half
+//    runs a short slice, and the halves are merged back, over and over.
+enum class Scenario { None, MassRemoval, MostlyPaused, SplitMerge };
+
+inline const char* scenarioName(Scenario s) {
+    switch (s) {
+    case Scenario::MassRemoval: return "mass-removal";
+    case Scenario::MostlyPaused: return "mostly-paused";
+    case Scenario::SplitMerge: return "split-merge";
+    default: return "none";
+    }
+}
+
+inline bool parseScenario(const std::string& name, Scenario& s) {
+    for (Scenario c : {Scenario::MassRemoval, Scenario::MostlyPaused, Scenario::SplitMerge})
+        if (name == scenarioName(c)) { s = c; return true; }
+    return false;
+}
+
+// The scenario's fleet shape on top of spec (size and seed are kept)
+inline FleetSpec scenarioFleet(Scenario s, FleetSpec spec) {
+    if (s == Scenario::MassRemoval) {
+        spec.battery = FleetDist::uniform(1, 8);
+        spec.drain = FleetDist::uniform(1, 1);
+        spec.pausedPct = 0;
+    } else if (s == Scenario::MostlyPaused) {
+        spec.battery = FleetDist::zipf(50, 50000);
+        spec.drain = FleetDist::uniform(1, 3);
+        spec.pausedPct = 90;
+    } else if (s == Scenario::SplitMerge) {
+        spec.battery = FleetDist::bimodal(10, 100000, 20);
+        spec.drain = FleetDist::uniform(1, 1);
+        spec.pausedPct = 0;
+    }
+    return spec;
+}
+
+struct ScenarioStats {
+    TurnStats turns;
+    long long rounds = 0;           // split-merge rounds
+};
+
+// Run up to n ticks of scenario s on ring (built with scenarioFleet).
+// run(r, k) advances r, the ring or one of its halves, by k ticks and
+// returns their stats; split-merge gives each half `slice` ticks a round, or
+// as many ticks as the ring has robots if that is more, so the O(n) split
+// and merge (RobotRing moves its id index) stay a bounded cost per tick.
+template <typename Ring, typename Run>
+ScenarioStats runScenario(Scenario s, Ring& ring, long long n, Run&& run, long long slice = 4096) {
+    ScenarioStats out;
+    if (s != Scenario::SplitMerge) {
+        out.turns = run(ring, n);
+        return out;
+    }
+    Ring a(ring.get_allocator()), b(ring.get_allocator());
+    slice = std::max(slice, static_cast<long long>(ring.size()));
+    while (out.turns.ticks < n && !ring.empty()) {
+        ring.splitIntoTwo(a, b);
+        const long long left = n - out.turns.ticks;
+        TurnStats sa = run(a, std::min(slice, left));
+        TurnStats sb = run(b, std::min(slice, left - sa.ticks));
+        ring.mergeWith(a);
+        ring.mergeWith(b);
+        out.turns += sa;
+        out.turns += sb;
+        ++out.rounds;
+        if (sa.ticks + sb.ticks == 0) break;        // nothing left to run
+    }
+    return out;
+}
+
+// Round-robin through runTurns, as the benchmarks use it
+template <typename Ring>
+ScenarioStats runScenario(Scenario s, Ring& ring, long long n, TurnMode mode = TurnMode::FastForward) {
+    return runScenario(s, ring, n, [mode](Ring& r, long long k) { return runTurns(r, k, nullptr, mode); });
+}
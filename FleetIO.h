@@ -0,0 +1,170 @@
+// FleetIO.h
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Robot.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define FLEETIO_HAVE_MMAP 1
+#endif
+
+// Read-only view of a whole file: memory-mapped where available, otherwise
+// read into a buffer. data() is empty if the file could not be opened.
+class MappedFile {
+private:
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+    std::string fallback_;          // used when mmap is unavailable
+    bool mapped_ = false;
+
+public:
+    explicit MappedFile(const std::string& path) {
+#ifdef FLEETIO_HAVE_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            struct stat st;
+            if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+                void* p = ::mmap(nullptr, static_cast<std::size_t>(st.st_size),
+                                 PROT_READ, MAP_PRIVATE, fd, 0);
+                if (p != MAP_FAILED) {
+                    data_ = static_cast<const char*>(p);
+                    size_ = static_cast<std::size_t>(st.st_size);
+                    mapped_ = true;
+                }
+            }
+            ::close(fd);
+            if (mapped_) return;
+        }
+#endif
+        std::ifstream in(path, std::ios::binary);
+        if (!in) return;
+        fallback_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        data_ = fallback_.data();
+        size_ = fallback_.size();
+    }
+    ~MappedFile() {
+#ifdef FLEETIO_HAVE_MMAP
+        if (mapped_) ::munmap(const_cast<char*>(data_), size_);
+#endif
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool ok() const { return data_ != nullptr; }
+    std::string_view data() const { return {data_ ? data_ : "", size_}; }
+};
+
+struct FleetLoadResult {
+    bool ok = false;
+    std::string error;              // set when !ok
+    std::size_t loaded = 0;         // robots appended
+    std::size_t skipped = 0;        // malformed lines
+    double seconds = 0.0;
+
+    double robotsPerSecond() const { return seconds > 0 ? loaded / seconds : 0.0; }
+};
+
+namespace fleetio {
+
+// Parse an optionally signed decimal int at p; advances p. No locale, no
+// allocation.
+inline bool parseInt(const char*& p, const char* end, int& out) {
+    bool neg = false;
+    if (p < end && (*p == '-' || *p == '+')) { neg = (*p == '-'); ++p; }
+    if (p >= end || *p < '0' || *p > '9') return false;
+    long long v = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        v = v * 10 + (*p - '0');
+        if (v > 2147483648LL) return false;
+        ++p;
+    }
+    v = neg ? -v : v;
+    if (v > 2147483647LL) return false;
+    out = static_cast<int>(v);
+    return true;
+}
+
+inline std::string_view trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r')) s.remove_suffix(1);
+    return s;
+}
+
+// Numeric field: the whole (trimmed) field must be an int
+inline bool parseField(std::string_view f, int& out) {
+    f = trim(f);
+    const char* p = f.data();
+    const char* end = p + f.size();
+    return parseInt(p, end, out) && p == end;
+}
+
+} // namespace fleetio
+
+// Bulk import from CSV, one robot per line:
+//     name,battery[,drain[,paused]]
+// drain defaults to quantum and paused (0/1) to 0. Blank lines, '#' comments
+// and a "name,battery,..." header are ignored; other malformed lines are
+// counted in skipped. Ids are assigned from nextId in file order, and the
+// whole batch goes into the ring through one append_range.
+template <typename Ring>
+FleetLoadResult loadFleetCsv(const std::string& path, Ring& ring, int& nextId, int quantum) {
+    using clock = std::chrono::steady_clock;
+    const auto t0 = clock::now();
+    FleetLoadResult res;
+
+    MappedFile file(path);
+    if (!file.ok()) { res.error = "cannot open " + path; return res; }
+
+    std::string_view text = file.data();
+    std::vector<Robot> batch;
+    batch.reserve(text.size() / 16);          // rough guess at line length
+
+    std::size_t pos = 0;
+    bool first = true;
+    while (pos < text.size()) {
+        std::size_t eol = text.find('\n', pos);
+        if (eol == std::string_view::npos) eol = text.size();
+        std::string_view line = fleetio::trim(text.substr(pos, eol - pos));
+        pos = eol + 1;
+        if (line.empty() || line.front() == '#') continue;
+
+        std::string_view fields[4];
+        std::size_t nf = 0;
+        while (nf < 4) {
+            std::size_t comma = line.find(',');
+            fields[nf++] = line.substr(0, comma);
+            if (comma == std::string_view::npos) { line = {}; break; }
+            line.remove_prefix(comma + 1);
+        }
+        bool header = first && nf >= 2 && fleetio::trim(fields[1]) == "battery";
+        first = false;
+        if (header) continue;
+
+        std::string_view name = fleetio::trim(fields[0]);
+        int battery = 0, drain = quantum, paused = 0;
+        if (!line.empty() || nf < 2 || name.empty()
+            || !fleetio::parseField(fields[1], battery)
+            || (nf > 2 && !fleetio::parseField(fields[2], drain))
+            || (nf > 3 && (!fleetio::parseField(fields[3], paused) || paused < 0 || paused > 1))) {
+            ++res.skipped;
+            continue;
+        }
+        batch.emplace_back(nextId++, Robot::NameArg(name), battery, drain, paused != 0);
+    }
+
+    ring.reserve(ring.size() + batch.size());
+    ring.append_range(std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+    res.loaded = batch.size();
+    res.ok = true;
+    res.seconds = std::chrono::duration<double>(clock::now() - t0).count();
+    return res;
+}
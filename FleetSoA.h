@@ -0,0 +1,157 @@
+// FleetSoA.h
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include "Robot.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define FLEETSOA_SIMD "avx2"
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define FLEETSOA_SIMD "neon"
+#else
+#define FLEETSOA_SIMD "scalar"
+#endif
+
+namespace soa {
+
+// One lap of drain over n lanes: b[i] -= d[i], unless that would take an
+// active lane (act[i] == -1) to <= 0. In that case nothing is changed and
+// the function returns false. Paused lanes have d[i] == 0 and act[i] == 0.
+// The update is fused with the depletion check; a hit undoes the lanes
+// already written (rare: at most once per removal).
+inline bool drainLap(int* b, const int* d, const int* act, std::size_t n) {
+    std::size_t i = 0;
+    bool hit = false;
+#if defined(__AVX2__)
+    const __m256i one = _mm256_set1_epi32(1);
+    for (; i + 8 <= n; i += 8) {
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        __m256i vd = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(d + i));
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(act + i));
+        __m256i nb = _mm256_sub_epi32(vb, vd);
+        __m256i dead = _mm256_and_si256(_mm256_cmpgt_epi32(one, nb), va);  // nb <= 0 && active
+        if (!_mm256_testz_si256(dead, dead)) { hit = true; break; }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(b + i), nb);
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    const int32x4_t one = vdupq_n_s32(1);
+    for (; i + 4 <= n; i += 4) {
+        int32x4_t nb = vsubq_s32(vld1q_s32(b + i), vld1q_s32(d + i));
+        uint32x4_t dead = vandq_u32(vcltq_s32(nb, one), vreinterpretq_u32_s32(vld1q_s32(act + i)));
+        if (vmaxvq_u32(dead)) { hit = true; break; }
+        vst1q_s32(b + i, nb);
+    }
+#endif
+    if (!hit) {
+        for (; i < n; ++i) {
+            int nb = b[i] - d[i];
+            if (act[i] && nb <= 0) { hit = true; break; }
+            b[i] = nb;
+        }
+    }
+    if (!hit) return true;
+    for (std::size_t j = 0; j < i; ++j) b[j] += d[j];   // roll back this lap
+    return false;
+}
+
+// drainLap for a drain shared by every active lane, so no drain array:
+// lane i loses d & act[i]. Quantum > 0 fixes the drain at compile time
+// (d is ignored); 0 takes d at run time. Lanes go in fixed blocks of 32
+// whose check and update have no branches, so the compiler unrolls and
+// vectorizes them for whatever the target offers (SSE2 upwards on x86);
+// a block with a depleted lane stops the lap before it is written.
+template <int Quantum>
+inline bool drainLapUniform(int* b, int d, const int* act, std::size_t n) {
+    if (Quantum > 0) d = Quantum;
+    constexpr std::size_t kBlock = 32;
+    std::size_t i = 0;
+    bool hit = false;
+    for (; i + kBlock <= n; i += kBlock) {
+        int nb[kBlock];
+        int dead = 0;
+        for (std::size_t j = 0; j < kBlock; ++j) {
+            nb[j] = b[i + j] - (d & act[i + j]);
+            dead |= act[i + j] & -(nb[j] <= 0);
+        }
+        if (dead) { hit = true; break; }
+        for (std::size_t j = 0; j < kBlock; ++j) b[i + j] = nb[j];
+    }
+    if (!hit) {
+        for (; i < n; ++i) {
+            int nb = b[i] - (d & act[i]);
+            if (act[i] && nb <= 0) { hit = true; break; }
+            b[i] = nb;
+        }
+    }
+    if (!hit) return true;
+    for (std::size_t j = 0; j < i; ++j) b[j] += d & act[j];     // roll back this lap
+    return false;
+}
+
+} // namespace soa
+
+// Structure-of-arrays copy of a ring, in ring order (head first). Used by
+// the batched turn engine: whole laps of drain run over the contiguous
+// battery array instead of walking the ring once per tick. When every
+// active robot has the same drain (the usual case: drain == quantum) the
+// drain array is not built and lap() runs a kernel specialized for it.
+struct FleetSoA {
+    std::vector<int> id;
+    std::vector<int> battery;
+    std::vector<int> drain;         // effective drain (0 for paused); empty if uniform
+    std::vector<int> active;        // -1 active, 0 paused (SIMD mask lanes)
+    std::size_t pausedCount = 0;
+    bool uniform = true;            // every active robot drains by quantum
+    int quantum = 0;
+
+    template <typename Ring>
+    void load(const Ring& ring) {
+        std::size_t m = ring.size();
+        id.clear(); battery.clear(); drain.clear(); active.clear();
+        id.reserve(m); battery.reserve(m); active.reserve(m);
+        pausedCount = 0;
+        uniform = true;
+        bool seen = false;          // an active robot has set quantum
+        ring.forEach([&](const Robot& r) {
+            const int d = r.paused ? 0 : r.drain;
+            if (uniform && !r.paused && seen && d != quantum) {
+                // first mismatch: spell out the lanes so far, all quantum or paused
+                uniform = false;
+                drain.reserve(m);
+                for (int a : active) drain.push_back(quantum & a);
+            }
+            if (!uniform) drain.push_back(d);
+            else if (!r.paused && !seen) { quantum = d; seen = true; }
+            id.push_back(r.id);
+            battery.push_back(r.battery);
+            active.push_back(r.paused ? 0 : -1);
+            pausedCount += r.paused ? 1 : 0;
+        });
+    }
+
+    // Write batteries back; the ring must not have changed order since load()
+    template <typename Ring>
+    void storeBatteries(Ring& ring) const {
+        std::size_t i = 0;
+        ring.forEach([&](Robot& r) { r.battery = battery[i++]; });
+    }
+
+    std::size_t size() const { return battery.size(); }
+
+    // One full lap of round-robin if no robot would be removed during it.
+    // Mixed drains take the general kernel; common quanta get a
+    // compile-time drain.
+    bool lap() {
+        int* b = battery.data();
+        const int* a = active.data();
+        if (!uniform) return soa::drainLap(b, drain.data(), a, size());
+        switch (quantum) {
+        case 1: return soa::drainLapUniform<1>(b, 1, a, size());
+        case 2: return soa::drainLapUniform<2>(b, 2, a, size());
+        default: return soa::drainLapUniform<0>(b, quantum, a, size());
+        }
+    }
+};
@@ -0,0 +1,237 @@
+// Instrument.h
+#pragma once
+
+// Hot-path instrumentation, compiled in with -DROBOT_RING_INSTRUMENT.
+// Without it the ROBOT_RING_COUNT/ROBOT_RING_MAX hooks (LinkedList) expand
+// to nothing, arguments included, and nothing below is even declared, so a
+// normal build pays nothing.
+#ifdef ROBOT_RING_INSTRUMENT
+#define ROBOT_RING_COUNT(counter, n) ::instrument::bump(::instrument::Counter::counter, (n))
+#define ROBOT_RING_MAX(counter, x) ::instrument::raise(::instrument::Counter::counter, (x))
+#else
+#define ROBOT_RING_COUNT(counter, n) ((void)0)
+#define ROBOT_RING_MAX(counter, x) ((void)0)
+#endif
+
+#ifdef ROBOT_RING_INSTRUMENT
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+// Counters are per thread: each thread bumps its own block with relaxed
+// loads and stores (no locked instructions), and reads sum the blocks, so
+// ParallelSim workers count without contending for a cache line. Totals
+// are exact once the workers are idle.
+namespace instrument {
+
+enum class Counter {
+    NodeAllocs, NodeFrees, Rotations, Pops,
+    Splits, SplitElements, SplitMax,
+    Merges, MergeElements, MergeMax,
+    Runs, Ticks, Skipped, Removed,
+    kCount
+};
+constexpr int kCounters = static_cast<int>(Counter::kCount);
+
+inline const char* counterName(Counter c) {
+    static const char* const names[kCounters] = {
+        "node_allocs", "node_frees", "rotations", "pops",
+        "splits", "split_elements", "split_max",
+        "merges", "merge_elements", "merge_max",
+        "runs", "ticks", "skipped", "removed",
+    };
+    return names[static_cast<int>(c)];
+}
+
+// Maxima combine across threads by max, everything else by sum
+inline bool isMax(Counter c) { return c == Counter::SplitMax || c == Counter::MergeMax; }
+
+// One thread's counters; only the owning thread writes
+struct Block {
+    std::atomic<std::uint64_t> v[kCounters] = {};
+};
+
+// Every block ever handed out. Blocks outlive their threads so the counts
+// of finished workers stay in the totals.
+class Registry {
+private:
+    std::mutex m_;
+    std::vector<std::unique_ptr<Block>> blocks_;
+
+public:
+    Block& add() {
+        std::lock_guard<std::mutex> lock(m_);
+        blocks_.push_back(std::make_unique<Block>());
+        return *blocks_.back();
+    }
+    template <typename F>
+    void forEach(F&& f) {
+        std::lock_guard<std::mutex> lock(m_);
+        for (auto& b : blocks_) f(*b);
+    }
+};
+
+inline Registry& registry() { static Registry r; return r; }
+inline Block& local() { thread_local Block& b = registry().add(); return b; }
+
+inline void bump(Counter c, std::uint64_t n) {
+    std::atomic<std::uint64_t>& a = local().v[static_cast<int>(c)];
+    a.store(a.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+inline void raise(Counter c, std::uint64_t x) {
+    std::atomic<std::uint64_t>& a = local().v[static_cast<int>(c)];
+    if (x > a.load(std::memory_order_relaxed)) a.store(x, std::memory_order_relaxed);
+}
+
+inline std::uint64_t total(Counter c) {
+    std::uint64_t t = 0;
+    registry().forEach([&](const Block& b) {
+        const std::uint64_t x = b.v[static_cast<int>(c)].load(std::memory_order_relaxed);
+        t = isMax(c) ? (x > t ? x : t) : t + x;
+    });
+    return t;
+}
+
+// Log-linear histogram in the style of HdrHistogram: exact below 32, then
+// 16 buckets per power of two (about 6% relative precision) up to 2^64, in
+// a fixed 976-slot table, so record() is a few instructions and never
+// allocates. Not thread safe: one per recording thread.
+class Histogram {
+private:
+    static constexpr int kExact = 32;
+    static constexpr int kSub = 16;
+    static constexpr int kBuckets = kExact + 59 * kSub;
+
+    std::uint64_t counts_[kBuckets] = {};
+    std::uint64_t total_ = 0;
+    std::uint64_t min_ = std::numeric_limits<std::uint64_t>::max();
+    std::uint64_t max_ = 0;
+    long double sum_ = 0;
+
+    static int highestBit(std::uint64_t x) {
+#if defined(__GNUC__)
+        return 63 - __builtin_clzll(x);
+#else
+        int i = 63;
+        while (!(x >> i)) --i;
+        return i;
+#endif
+    }
+    static int bucketOf(std::uint64_t v) {
+        if (v < static_cast<std::uint64_t>(kExact)) return static_cast<int>(v);
+        const int shift = highestBit(v) - 4;           // v >> shift is in [16, 32)
+        return kExact + (shift - 1) * kSub + static_cast<int>((v >> shift) - kSub);
+    }
+    static std::uint64_t lowOf(int i) {
+        if (i < kExact) return static_cast<std::uint64_t>(i);
+        const int shift = (i - kExact) / kSub + 1;
+        return static_cast<std::uint64_t>(kSub + (i - kExact) % kSub) << shift;
+    }
+    static std::uint64_t highOf(int i) {
+        if (i < kExact) return static_cast<std::uint64_t>(i);
+        const int shift = (i - kExact) / kSub + 1;
+        return lowOf(i) + ((std::uint64_t(1) << shift) - 1);
+    }
+
+public:
+    void record(std::uint64_t v, std::uint64_t n = 1) {
+        if (!n) return;
+        counts_[bucketOf(v)] += n;
+        total_ += n;
+        sum_ += static_cast<long double>(v) * n;
+        if (v < min_) min_ = v;
+        if (v > max_) max_ = v;
+    }
+
+    std::uint64_t count() const { return total_; }
+    std::uint64_t min() const { return total_ ? min_ : 0; }
+    std::uint64_t max() const { return max_; }
+    double mean() const { return total_ ? static_cast<double>(sum_ / total_) : 0.0; }
+
+    // Upper end of the bucket holding the p-th percentile sample (capped at
+    // the largest value seen); 0 when empty
+    std::uint64_t percentile(double p) const {
+        if (!total_) return 0;
+        std::uint64_t want = static_cast<std::uint64_t>(p / 100.0 * static_cast<double>(total_) + 0.5);
+        if (want < 1) want = 1;
+        std::uint64_t seen = 0;
+        for (int i = 0; i < kBuckets; ++i) {
+            seen += counts_[i];
+            if (seen >= want) return highOf(i) < max_ ? highOf(i) : max_;
+        }
+        return max_;
+    }
+
+    // f(low, high, count) for each non-empty bucket, lowest first
+    template <typename F>
+    void forEachBucket(F&& f) const {
+        for (int i = 0; i < kBuckets; ++i)
+            if (counts_[i]) f(lowOf(i), highOf(i), counts_[i]);
+    }
+
+    void clear() { *this = Histogram(); }
+};
+
+// Per-tick latency in ns, recorded by main.cpp's tick loop (main thread)
+inline Histogram& tickLatency() { static Histogram h; return h; }
+
+// One run of the tick engine: n ticks, of which skipped were spent on paused
+// robots, in ns. A single tick is recorded as is; a longer run enters the
+// histogram as n samples of its mean.
+inline void recordRun(long long n, long long skipped, long long removed, std::uint64_t ns) {
+    if (n <= 0) return;
+    bump(Counter::Runs, 1);
+    bump(Counter::Ticks, static_cast<std::uint64_t>(n));
+    bump(Counter::Skipped, static_cast<std::uint64_t>(skipped));
+    bump(Counter::Removed, static_cast<std::uint64_t>(removed));
+    tickLatency().record(ns / static_cast<std::uint64_t>(n), static_cast<std::uint64_t>(n));
+}
+
+// Lines for statsReport and the headless summary
+inline void report(std::ostream& os) {
+    auto t = [](Counter c) { return total(c); };
+    auto mean = [](std::uint64_t sum, std::uint64_t n) { return n ? static_cast<double>(sum) / n : 0.0; };
+    const std::uint64_t ticks = t(Counter::Ticks), skipped = t(Counter::Skipped);
+    const Histogram& h = tickLatency();
+    os << "Instrumentation:\n";
+    os << "  Nodes: " << t(Counter::NodeAllocs) << " allocated, " << t(Counter::NodeFrees) << " freed\n";
+    os << "  Rotations: " << t(Counter::Rotations) << ", pops: " << t(Counter::Pops) << "\n";
+    os << "  Splits: " << t(Counter::Splits) << " (mean " << mean(t(Counter::SplitElements), t(Counter::Splits))
+       << " elements, max " << t(Counter::SplitMax) << "), merges: " << t(Counter::Merges) << " (mean "
+       << mean(t(Counter::MergeElements), t(Counter::Merges)) << " elements, max " << t(Counter::MergeMax) << ")\n";
+    os << "  Ticks: " << ticks << " in " << t(Counter::Runs) << " runs, active " << ticks - skipped
+       << ", skipped " << skipped << " (" << std::fixed << std::setprecision(1)
+       << 100.0 * mean(skipped, ticks) << "%)" << std::defaultfloat << std::setprecision(6)
+       << ", removed " << t(Counter::Removed) << "\n";
+    os << "  Tick latency (ns): p50 " << h.percentile(50) << ", p90 " << h.percentile(90)
+       << ", p99 " << h.percentile(99) << ", p99.9 " << h.percentile(99.9) << ", max " << h.max()
+       << ", mean " << h.mean() << "\n";
+}
+
+// Every counter and the latency histogram as one JSON object
+inline void dumpJson(std::ostream& os) {
+    const Histogram& h = tickLatency();
+    os << "{\n  \"counters\": {";
+    for (int i = 0; i < kCounters; ++i)
+        os << (i ? ", " : "") << "\"" << counterName(static_cast<Counter>(i)) << "\": "
+           << total(static_cast<Counter>(i));
+    os << "},\n  \"tick_latency_ns\": {\"count\": " << h.count() << ", \"min\": " << h.min()
+       << ", \"mean\": " << h.mean() << ", \"p50\": " << h.percentile(50) << ", \"p90\": " << h.percentile(90)
+       << ", \"p99\": " << h.percentile(99) << ", \"p999\": " << h.percentile(99.9) << ", \"max\": " << h.max()
+       << ",\n    \"buckets\": [";
+    const char* sep = "";
+    h.forEachBucket([&](std::uint64_t lo, std::uint64_t hi, std::uint64_t n) {
+        os << sep << "[" << lo << ", " << hi << ", " << n << "]";
+        sep = ", ";
+    });
+    os << "]}\n}\n";
+}
+
+} // namespace instrument
+#endif
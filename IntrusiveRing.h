@@ -0,0 +1,242 @@
+// IntrusiveRing.h
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include "Robot.h"
+
+// Link embedded in an element: one per ring the element can belong to at a
+// time. A copied element starts out unlinked (copying the pointer would put
+// the copy in the original's ring).
+template <typename T>
+struct RingHook {
+    T* next = nullptr;                  // nullptr while not in a ring
+
+    RingHook() = default;
+    RingHook(const RingHook&) {}
+    RingHook& operator=(const RingHook&) { return *this; }
+
+    bool linked() const { return next != nullptr; }
+};
+
+// Circular singly linked list that links caller-owned objects through the
+// hook member Hook instead of copying them into nodes: append, pop_front,
+// rotate, splitIntoTwo and mergeWith never allocate, and an object with
+// several hooks can sit in several rings at once (see HookedRobot). The
+// ring does not own its elements; pop_front/erase/clear only unlink.
+//
+// Elements must stay put while linked (e.g. reserve a fleet vector up front)
+// and must outlive their ring, whose destructor unlinks them. Same API and
+// invariants as LinkedList (tail_->next == head_), so stepTurn/runTurns run
+// on it directly; handles are element pointers.
+template <typename T, RingHook<T> T::*Hook>
+class IntrusiveRing {
+private:
+    T* head_ = nullptr;
+    T* tail_ = nullptr;
+    std::size_t sz_ = 0;
+    T* mid_ = nullptr;              // element (sz_-1)/2, as in LinkedList; nullptr if unknown
+
+    static T*& next(T* x) { return (x->*Hook).next; }
+    static T* next(const T* x) { return (x->*Hook).next; }
+
+    void _checkInvariant() const {
+#ifndef NDEBUG
+        if (!head_) { assert(tail_ == nullptr && sz_ == 0); return; }
+        assert(tail_ && next(tail_) == head_ && "broken circular invariant");
+        assert((sz_ == 1) == (head_ == tail_) && "size/single-node mismatch");
+#ifdef LINKEDLIST_DEEP_CHECK
+        const T* cur = head_;
+        for (std::size_t i = 0; i < sz_; ++i, cur = next(cur))
+            assert((!mid_ || i != (sz_ - 1) / 2 || cur == mid_) && "stale midpoint");
+        assert(cur == head_ && "walk sz_ steps must wrap to head");
+#endif
+#endif
+    }
+
+public:
+    using value_type = T;
+    using handle = T*;
+    static constexpr bool stable_handles = true;
+
+    IntrusiveRing() = default;
+    ~IntrusiveRing() { clear(); }
+    IntrusiveRing(const IntrusiveRing&) = delete;
+    IntrusiveRing& operator=(const IntrusiveRing&) = delete;
+
+    bool empty() const { return head_ == nullptr; }
+    std::size_t size() const { return sz_; }
+
+    // ---- core operations ----
+
+    // Link x after the tail; x must not be in a ring through this hook
+    void append(T& x) {
+        assert(!(x.*Hook).linked() && "element already linked through this hook");
+        if (!head_) head_ = mid_ = &x;
+        else next(tail_) = &x;
+        tail_ = &x;
+        next(tail_) = head_;
+        if (mid_ && sz_ && sz_ % 2 == 0) mid_ = next(mid_);
+        ++sz_;
+        _checkInvariant();
+    }
+
+    // Link [first, last) in order (e.g. a whole fleet array)
+    template <typename It>
+    void append_range(It first, It last) { for (; first != last; ++first) append(*first); }
+
+    // Unlink the head; the object itself is left alone
+    bool pop_front() {
+        if (!head_) return false;
+        T* old = head_;
+        if (head_ == tail_) head_ = tail_ = mid_ = nullptr;
+        else {
+            if (mid_ && sz_ % 2 == 0) mid_ = next(mid_);
+            head_ = next(head_);
+            next(tail_) = head_;
+        }
+        next(old) = nullptr;
+        --sz_;
+        _checkInvariant();
+        return true;
+    }
+
+    // Unlink h from any position: a walk to the predecessor, O(1) at the head
+    void erase(handle h) {
+        if (h == head_) { pop_front(); return; }
+        T* prev = head_;
+        while (next(prev) != h) prev = next(prev);
+        next(prev) = next(h);
+        if (h == tail_) tail_ = prev;
+        next(h) = nullptr;
+        --sz_;
+        mid_ = nullptr;
+        _checkInvariant();
+    }
+
+    void rotate() {
+        if (!head_ || head_ == tail_) return;
+        head_ = next(head_);
+        tail_ = next(tail_);
+        if (mid_) mid_ = next(mid_);
+    }
+
+    T& front() { return *head_; }
+    const T& front() const { return *head_; }
+
+    handle front_handle() const { return head_; }
+    handle back_handle() const { return tail_; }
+    T& at(handle h) { return *h; }
+    const T& at(handle h) const { return *h; }
+    std::size_t generation() const { return 0; }   // elements never move
+
+    template <typename F>
+    void forEachHandle(F&& f) {
+        T* cur = head_;
+        for (std::size_t i = 0; i < sz_; ++i) {
+            T* nxt = next(cur);
+            f(cur, *cur);
+            cur = nxt;
+        }
+    }
+
+    // Same format as LinkedList::display
+    void display() const {
+        if (!head_) { std::cout << "[] (empty)\n"; return; }
+        std::cout << "[";
+        const T* cur = head_;
+        for (std::size_t i = 0; i < sz_; ++i) {
+            std::cout << *cur;
+            if (i + 1 < sz_) std::cout << " -> ";
+            cur = next(cur);
+        }
+        std::cout << "] (circular)\n";
+    }
+
+    template <typename F>
+    void forEach(F&& f) const {
+        const T* cur = head_;
+        for (std::size_t i = 0; i < sz_; ++i) {
+            f(*cur);
+            cur = next(cur);
+        }
+    }
+
+    template <typename F>
+    void forEach(F&& f) {
+        T* cur = head_;
+        for (std::size_t i = 0; i < sz_; ++i) {
+            T* nxt = next(cur);
+            f(*cur);
+            cur = nxt;
+        }
+    }
+
+    // Unlink everything (O(n): each hook is reset so the objects can join
+    // another ring)
+    void clear() {
+        T* cur = head_;
+        for (std::size_t i = 0; i < sz_; ++i) {
+            T* nxt = next(cur);
+            next(cur) = nullptr;
+            cur = nxt;
+        }
+        head_ = tail_ = mid_ = nullptr;
+        sz_ = 0;
+    }
+
+    // ---- split & merge ----
+
+    // first gets ceil(n/2), second gets floor(n/2). This ring becomes empty.
+    // O(1) through the cached midpoint, else one walk of n/2 links (after a
+    // split, merge or erase); nothing is copied.
+    void splitIntoTwo(IntrusiveRing& first, IntrusiveRing& second) {
+        first.clear(); second.clear();
+        if (!head_) return;
+        const std::size_t n1 = (sz_ + 1) / 2;
+        T* cut = mid_;
+        if (!cut) {
+            cut = head_;
+            for (std::size_t i = 1; i < n1; ++i) cut = next(cut);
+        }
+        T* head2 = next(cut);
+
+        first.head_ = head_; first.tail_ = cut; first.sz_ = n1;
+        next(cut) = head_;
+        if (sz_ > n1) {
+            second.head_ = head2; second.tail_ = tail_; second.sz_ = sz_ - n1;
+            next(tail_) = head2;
+        }
+        head_ = tail_ = mid_ = nullptr; sz_ = 0;
+        first._checkInvariant();
+        second._checkInvariant();
+    }
+
+    // Splice other after our tail in O(1); 'other' becomes empty
+    void mergeWith(IntrusiveRing& other) {
+        if (other.empty()) return;
+        if (empty()) {
+            head_ = other.head_; tail_ = other.tail_; sz_ = other.sz_; mid_ = other.mid_;
+        } else {
+            next(tail_) = other.head_;
+            next(other.tail_) = head_;
+            tail_ = other.tail_;
+            sz_ += other.sz_;
+            mid_ = nullptr;
+        }
+        other.head_ = other.tail_ = other.mid_ = nullptr; other.sz_ = 0;
+        _checkInvariant();
+    }
+};
+
+// A Robot that can be in two intrusive rings at once, e.g. the active
+// rotation and a maintenance queue, without being copied
+struct HookedRobot : Robot {
+    using Robot::Robot;
+
+    RingHook<HookedRobot> active;
+    RingHook<HookedRobot> maintenance;
+};
+
+using ActiveRing = IntrusiveRing<HookedRobot, &HookedRobot::active>;
+using MaintenanceRing = IntrusiveRing<HookedRobot, &HookedRobot::maintenance>;
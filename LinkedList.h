@@ -2,88 +2,280 @@
 #pragma once
 #include <cstddef>
 #include <iostream>
+#include <iterator>
+#include <type_traits>
 #include <utility>
 #include <cassert>
+#include <memory>
+#include <vector>
+#include "Instrument.h"
+#include "PoolAllocator.h"
 
-template <typename T>
+#ifndef LINKEDLIST_CHECK_INTERVAL
+#define LINKEDLIST_CHECK_INTERVAL 0     // see _checkInvariant()
+#endif
+
+// Node link policies. SinglyLinked keeps one pointer per node (minimum
+// memory; erase(handle) walks to the predecessor). DoublyLinked adds a prev
+// pointer so erase(handle) is O(1) as well.
+struct SinglyLinked {};
+struct DoublyLinked {};
+
+// Alloc is rebound to the internal Node type. The default PoolAllocator gives
+// each list its own slab pool unless one is passed in; lists that exchange
+// nodes through splitIntoTwo/mergeWith should share a single allocator.
+template <typename T, typename Alloc = PoolAllocator<T>, typename Links = SinglyLinked>
 class LinkedList {
 private:
-    struct Node {
+    static_assert(std::is_same<Links, SinglyLinked>::value || std::is_same<Links, DoublyLinked>::value,
+                  "Links must be SinglyLinked or DoublyLinked");
+    static constexpr bool kDoubly = std::is_same<Links, DoublyLinked>::value;
+
+    struct Node;
+    struct NextLink { Node* next = nullptr; };
+    struct BothLinks { Node* next = nullptr; Node* prev = nullptr; };
+
+    struct Node : std::conditional_t<kDoubly, BothLinks, NextLink> {
         T data;
-        Node* next;
-        explicit Node(const T& v) : data(v), next(nullptr) {}
-        explicit Node(T&& v) : data(std::move(v)), next(nullptr) {}
+        template <typename... Args>
+        explicit Node(std::in_place_t, Args&&... args) : data(std::forward<Args>(args)...) {}
     };
 
+    // The one place next (and prev) pointers are written
+    static void link(Node* a, Node* b) {
+        a->next = b;
+        if constexpr (kDoubly) b->prev = a;
+    }
+
+    using NodeAlloc  = typename std::allocator_traits<Alloc>::template rebind_alloc<Node>;
+    using NodeTraits = std::allocator_traits<NodeAlloc>;
+
+    NodeAlloc alloc_;
     Node* head_ = nullptr;          // nullptr when empty
     Node* tail_ = nullptr;          // nullptr when empty; else tail_->next == head_
     std::size_t sz_ = 0;            // cached size
+    Node* mid_ = nullptr;           // node (sz_-1)/2, last of the first half;
+                                    // nullptr when empty or dropped by an erase
+    std::size_t gen_ = 0;           // bumped when a merge had to copy nodes
+
+    template <typename... Args>
+    Node* make_node(Args&&... args) {
+        Node* n = NodeTraits::allocate(alloc_, 1);
+        ROBOT_RING_COUNT(NodeAllocs, 1);
+        try { NodeTraits::construct(alloc_, n, std::in_place, std::forward<Args>(args)...); }
+        catch (...) { NodeTraits::deallocate(alloc_, n, 1); throw; }
+        return n;
+    }
+
+    void destroy_node(Node* n) {
+        NodeTraits::destroy(alloc_, n);
+        NodeTraits::deallocate(alloc_, n, 1);
+        ROBOT_RING_COUNT(NodeFrees, 1);
+    }
 
     void make_single(Node* n) {
-        n->next = n;
-        head_ = tail_ = n;
+        link(n, n);
+        head_ = tail_ = mid_ = n;
         sz_ = 1;
     }
 
+    static Node* advance(Node* n, std::size_t k) {
+        while (k--) n = n->next;
+        return n;
+    }
+
+    // Splice an open chain h..t of n nodes after the tail and close the ring.
+    // The midpoint moves forward by half the batch.
+    void link_chain(Node* h, Node* t, std::size_t n) {
+        const std::size_t old = sz_;
+        if (!head_) head_ = h;
+        else link(tail_, h);
+        tail_ = t;
+        link(tail_, head_);
+        sz_ += n;
+        if (!old) mid_ = advance(head_, (sz_ - 1) / 2);
+        else if (mid_) mid_ = advance(mid_, (sz_ - 1) / 2 - (old - 1) / 2);
+#ifndef NDEBUG
+        _checkInvariant();
+#endif
+    }
+
+    // Allocators that can pre-carve node storage (PoolAllocator) expose reserve()
+    template <typename A>
+    static auto reserve_nodes(A& a, std::size_t n, int) -> decltype(a.reserve(n), void()) { a.reserve(n); }
+    template <typename A>
+    static void reserve_nodes(A&, std::size_t, long) {}
+
 #ifndef NDEBUG
+    // Debug checks, tiered so large rings stay usable in debug builds:
+    //  - every mutation runs the O(1) checks (null/size consistency,
+    //    tail_->next == head_);
+    //  - the full sz_-step walk runs on every mutation only with
+    //    LINKEDLIST_DEEP_CHECK, otherwise once per LINKEDLIST_CHECK_INTERVAL
+    //    mutations (0, the default, means once per size() mutations, which
+    //    keeps the walk amortized O(1)).
+    mutable std::size_t checksUntilWalk_ = 0;
+
+    void _walkCheck() const {
+        const Node* cur = head_;
+        for (std::size_t i = 0; i < sz_; ++i) {
+            assert((!mid_ || i != (sz_ - 1) / 2 || cur == mid_) && "stale midpoint");
+            if constexpr (kDoubly) assert(cur->next->prev == cur && "broken prev link");
+            cur = cur->next;
+        }
+        assert(cur == head_ && "walk sz_ steps must wrap to head");
+    }
+
     void _checkInvariant() const {
         if (!head_) { assert(tail_ == nullptr && sz_ == 0); return; }
         assert(tail_ && tail_->next == head_ && "broken circular invariant");
-        const Node* cur = head_;
-        for (std::size_t i = 0; i < sz_; ++i) cur = cur->next;
-        assert(cur == head_ && "walk sz_ steps must wrap to head");
+        assert(sz_ > 0 && (sz_ == 1) == (head_ == tail_) && "size/single-node mismatch");
+#ifdef LINKEDLIST_DEEP_CHECK
+        _walkCheck();
+#else
+        if (checksUntilWalk_ == 0) {
+            _walkCheck();
+            checksUntilWalk_ = LINKEDLIST_CHECK_INTERVAL ? LINKEDLIST_CHECK_INTERVAL : sz_;
+        }
+        --checksUntilWalk_;
+#endif
     }
 #endif
 
+    // Forward iterator over the ring. It counts the links it has followed,
+    // and that count is what iterators compare on: a circular walk ends after
+    // an exact number of steps instead of at a node, so end() of a one-lap
+    // walk is "size() steps from begin". Compare only iterators of one walk.
+    template <bool Const>
+    class Iter {
+    private:
+        friend class LinkedList;
+        template <bool> friend class Iter;
+        using NodePtr = std::conditional_t<Const, const Node*, Node*>;
+
+        NodePtr node_ = nullptr;
+        std::size_t step_ = 0;
+
+        Iter(NodePtr n, std::size_t step) : node_(n), step_(step) {}
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const T*, T*>;
+        using reference = std::conditional_t<Const, const T&, T&>;
+
+        Iter() = default;
+        template <bool C = Const, typename = std::enable_if_t<C>>
+        Iter(const Iter<false>& it) : node_(it.node_), step_(it.step_) {}
+
+        reference operator*() const { return node_->data; }
+        pointer operator->() const { return &node_->data; }
+        Iter& operator++() { node_ = node_->next; ++step_; return *this; }
+        Iter operator++(int) { Iter t = *this; ++*this; return t; }
+
+        // Steps taken since the start of the walk
+        std::size_t step() const { return step_; }
+
+        friend bool operator==(const Iter& a, const Iter& b) { return a.step_ == b.step_; }
+        friend bool operator!=(const Iter& a, const Iter& b) { return a.step_ != b.step_; }
+    };
+
+    // begin/end pair for walks longer than one lap or not starting at head
+    template <typename It>
+    struct Walk {
+        It first, last;
+        It begin() const { return first; }
+        It end() const { return last; }
+    };
+
 public:
+    using allocator_type = Alloc;
+    using value_type = T;
+    using iterator = Iter<false>;
+    using const_iterator = Iter<true>;
+    // Opaque element handle. Stays valid until that element is popped or
+    // cleared, including while its node moves between lists via split/merge
+    // (except a merge across distinct allocators, which bumps generation()).
+    using handle = Node*;
+    static constexpr bool stable_handles = true;
+
     LinkedList() = default;
+    explicit LinkedList(const Alloc& alloc) : alloc_(alloc) {}
+    template <typename InputIt,
+              typename = std::enable_if_t<!std::is_integral<InputIt>::value>>
+    LinkedList(InputIt first, InputIt last, const Alloc& alloc = Alloc()) : alloc_(alloc) {
+        append_range(first, last);
+    }
     ~LinkedList() { clear(); }
 
+    allocator_type get_allocator() const { return allocator_type(alloc_); }
+
     bool empty() const { return head_ == nullptr; }
     std::size_t size() const { return sz_; }
 
     // ---- core operations ----
 
     // O(1) append using tail_ pointer; preserves tail_->next == head_
-    void append(const T& value) {
-        Node* n = new Node(value);
-        if (!head_) { make_single(n); return; }
-        n->next = head_;
-        tail_->next = n;
-        tail_ = n;
-        ++sz_;
-#ifndef NDEBUG
-        _checkInvariant();
-#endif
+    void append(const T& value) { emplace_back(value); }
+    void append(T&& value) { emplace_back(std::move(value)); }
+
+    // Construct the element in place at the tail
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        Node* n = make_node(std::forward<Args>(args)...);
+        if (!head_) make_single(n);
+        else link_chain(n, n, 1);
+        return n->data;
     }
-    void append(T&& value) {
-        Node* n = new Node(std::move(value));
-        if (!head_) { make_single(n); return; }
-        n->next = head_;
-        tail_->next = n;
-        tail_ = n;
-        ++sz_;
-#ifndef NDEBUG
-        _checkInvariant();
-#endif
+
+    // Bulk append: the batch is built as an open chain and spliced in with
+    // one relink (and one debug check). For forward ranges the node storage
+    // is reserved up front. If an element throws, the list is unchanged.
+    template <typename InputIt>
+    void append_range(InputIt first, InputIt last) {
+        using Cat = typename std::iterator_traits<InputIt>::iterator_category;
+        if constexpr (std::is_base_of<std::forward_iterator_tag, Cat>::value)
+            reserve_nodes(alloc_, static_cast<std::size_t>(std::distance(first, last)), 0);
+        Node* h = nullptr;
+        Node* t = nullptr;
+        std::size_t n = 0;
+        try {
+            for (; first != last; ++first, ++n) {
+                Node* x = make_node(*first);
+                if (h) link(t, x); else h = x;
+                t = x;
+            }
+        } catch (...) {
+            for (; n > 0; --n) { Node* nxt = h->next; destroy_node(h); h = nxt; }
+            throw;
+        }
+        if (n) link_chain(h, t, n);
     }
 
-    // Remove head safely; empty/single/many handled
+    // Room for n nodes in all, like vector::reserve: the shortfall is
+    // pre-carved in one block (no-op for allocators without reserve(), e.g.
+    // std::allocator)
+    void reserve(std::size_t n) { if (n > sz_) reserve_nodes(alloc_, n - sz_, 0); }
+
+    // Remove head safely; empty/single/many handled (node goes back to the pool)
     bool pop_front() {
         if (!head_) return false;                  // empty
+        ROBOT_RING_COUNT(Pops, 1);
         Node* old = head_;
         if (head_ == tail_) {                      // single node
-            delete old;
-            head_ = tail_ = nullptr;
+            destroy_node(old);
+            head_ = tail_ = mid_ = nullptr;
             sz_ = 0;
 #ifndef NDEBUG
             _checkInvariant();
 #endif
             return true;
         }
+        if (mid_ && sz_ % 2 == 0) mid_ = mid_->next;  // (sz_-1)/2 stays put for odd sizes
         head_ = head_->next;                       // advance head
-        tail_->next = head_;                       // re-close ring
-        delete old;
+        link(tail_, head_);                        // re-close ring
+        destroy_node(old);
         --sz_;
 #ifndef NDEBUG
         _checkInvariant();
@@ -91,11 +283,60 @@ public:
         return true;
     }
 
+    // Remove the element at h (any position). O(1) with DoublyLinked; with
+    // SinglyLinked the predecessor is found by a walk from head, O(n) unless
+    // h is the head. Drops the cached midpoint unless h is the head or the
+    // tail, whose rank is known.
+    void erase(handle h) {
+        if (h == head_) { pop_front(); return; }
+        Node* prev;
+        if constexpr (kDoubly) prev = h->prev;
+        else {
+            prev = head_;
+            while (prev->next != h) prev = prev->next;
+        }
+        link(prev, h->next);
+        if (h != tail_) mid_ = nullptr;
+        else {
+            tail_ = prev;                          // (sz_-1)/2 moves back one for odd sizes
+            if constexpr (kDoubly) { if (mid_ && sz_ % 2 == 1) mid_ = mid_->prev; }
+            else if (sz_ % 2 == 1) mid_ = nullptr;
+        }
+        destroy_node(h);
+        --sz_;
+#ifndef NDEBUG
+        _checkInvariant();
+#endif
+    }
+
+    // Construct an element right after h in ring order (after the tail: at
+    // the new tail) in O(1) with either link policy. Returns its handle.
+    // Drops the cached midpoint unless h is the midpoint or the tail.
+    template <typename... Args>
+    handle emplace_after(handle h, Args&&... args) {
+        Node* n = make_node(std::forward<Args>(args)...);
+        const bool afterMid = h == tail_ || h == mid_;   // rank known to be past (sz_-1)/2
+        link(n, h->next);
+        link(h, n);
+        if (h == tail_) tail_ = n;
+        if (!afterMid) mid_ = nullptr;
+        else if (mid_ && sz_ % 2 == 0) mid_ = mid_->next;  // (sz_-1)/2 moves up for even sizes
+        ++sz_;
+#ifndef NDEBUG
+        _checkInvariant();
+#endif
+        return n;
+    }
+    handle insert_after(handle h, const T& value) { return emplace_after(h, value); }
+    handle insert_after(handle h, T&& value) { return emplace_after(h, std::move(value)); }
+
     // Rotate one step: advance both head and tail if size >= 2
     void rotate() {
         if (!head_ || head_ == tail_) return;
+        ROBOT_RING_COUNT(Rotations, 1);
         head_ = head_->next;
         tail_ = tail_->next;
+        if (mid_) mid_ = mid_->next;
 #ifndef NDEBUG
         _checkInvariant();
 #endif
@@ -105,40 +346,66 @@ public:
     T& front() { return head_->data; }
     const T& front() const { return head_->data; }
 
-    // Print exactly sz_ nodes to avoid infinite loop
-    void display() const {
-        if (!head_) { std::cout << "[] (empty)\n"; return; }
-        std::cout << "[";
+    // Handle access (front_handle/back_handle are nullptr when empty)
+    handle front_handle() const { return head_; }
+    handle back_handle() const { return tail_; }
+    T& at(handle h) { return h->data; }
+    const T& at(handle h) const { return h->data; }
+    std::size_t generation() const { return gen_; }
+
+    // ---- iteration ----
+
+    // One lap, head first
+    iterator begin() { return iterator(head_, 0); }
+    iterator end() { return iterator(head_, sz_); }
+    const_iterator begin() const { return const_iterator(head_, 0); }
+    const_iterator end() const { return const_iterator(head_, sz_); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    // `laps` times round the ring from head, or from h:
+    //     for (Robot& r : ring.walk(2)) ...
+    Walk<iterator> walk(std::size_t laps) { return {begin(), iterator(head_, laps * sz_)}; }
+    Walk<const_iterator> walk(std::size_t laps) const {
+        return {begin(), const_iterator(head_, laps * sz_)};
+    }
+    Walk<iterator> walk_from(handle h, std::size_t laps = 1) { return {iterator(h, 0), iterator(h, laps * sz_)}; }
+    Walk<const_iterator> walk_from(handle h, std::size_t laps = 1) const {
+        return {const_iterator(h, 0), const_iterator(h, laps * sz_)};
+    }
+
+    // Visit (handle, element) pairs head first
+    template <typename F>
+    void forEachHandle(F&& f) {
         Node* cur = head_;
         for (std::size_t i = 0; i < sz_; ++i) {
-            std::cout << cur->data;
-            if (i + 1 < sz_) std::cout << " -> ";
-            cur = cur->next;
+            Node* nxt = cur->next;
+            f(cur, cur->data);
+            cur = nxt;
         }
+    }
+
+    // One lap (the iterators stop after exactly sz_ nodes)
+    void display() const {
+        if (!head_) { std::cout << "[] (empty)\n"; return; }
+        std::cout << "[";
+        const char* sep = "";
+        for (const T& x : *this) { std::cout << sep << x; sep = " -> "; }
         std::cout << "] (circular)\n";
     }
 
     // Iterate helper (const) – handy for stats/reporting
     template <typename F>
-    void forEach(F&& f) const {
-        if (!head_) return;
-        Node* cur = head_;
-        for (std::size_t i = 0; i < sz_; ++i) {
-            f(cur->data);
-            cur = cur->next;
-        }
-    }
+    void forEach(F&& f) const { for (const T& x : *this) f(x); }
+
+    // Mutable variant, head first – for bulk updates without rotating
+    template <typename F>
+    void forEach(F&& f) { for (T& x : *this) f(x); }
 
-    // Clear all nodes
+    // Clear all nodes (each is stepped past before it is destroyed)
     void clear() {
-        if (!head_) return;
-        Node* cur = head_;
-        for (std::size_t i = 0; i < sz_; ++i) {
-            Node* nxt = cur->next;
-            delete cur;
-            cur = nxt;
-        }
-        head_ = tail_ = nullptr;
+        for (iterator it = begin(); it != end();) destroy_node((it++).node_);
+        head_ = tail_ = mid_ = nullptr;
         sz_ = 0;
     }
 
@@ -146,55 +413,138 @@ public:
 
     // Split into two circular lists.
     // first gets ceil(n/2), second gets floor(n/2). This list becomes empty.
-    void splitIntoTwo(LinkedList<T>& first, LinkedList<T>& second) {
+    // O(1) through the cached midpoint; after an erase in the middle, or on
+    // a half of a previous split, it costs one walk of n/2 nodes to find it
+    // again.
+    void splitIntoTwo(LinkedList& first, LinkedList& second) {
+        if (head_ && !mid_) mid_ = advance(head_, (sz_ - 1) / 2);
+        splitAt((sz_ + 1) / 2, first, second);
+    }
+
+    // first gets the first k elements (all of them if k >= size()), second
+    // the rest. This list becomes empty. The cut is found by walking from
+    // the nearest anchor at or before it: head, midpoint or tail (k == n).
+    // Both targets adopt this list's allocator so the moved nodes are later
+    // released into the pool they were carved from. A target keeps a
+    // midpoint when it gets the whole list, or when the walk from the head
+    // passes first's midpoint (second's is then at most k/2 past ours);
+    // otherwise it is found again on its first split.
+    void splitAt(std::size_t k, LinkedList& first, LinkedList& second) {
         first.clear(); second.clear();
+        first.alloc_ = alloc_; second.alloc_ = alloc_;
         if (!head_) return;
+        if (k > sz_) k = sz_;
+        ROBOT_RING_COUNT(Splits, 1);
+        ROBOT_RING_COUNT(SplitElements, sz_);
+        ROBOT_RING_MAX(SplitMax, sz_);
 
-        if (sz_ == 1) {
-            first.head_ = head_; first.tail_ = tail_; first.sz_ = 1;
-            first.tail_->next = first.head_;
-            head_ = tail_ = nullptr; sz_ = 0;
-            return;
+        Node* cut = nullptr;                       // last node of first
+        Node* firstMid = nullptr;                  // node (k-1)/2, if known
+        Node* secondMid = nullptr;                 // node k + (sz_-k-1)/2, if known
+        const std::size_t m = (sz_ - 1) / 2;       // index of mid_
+        if (k == sz_) { cut = tail_; firstMid = mid_; }
+        else if (!k) secondMid = mid_;
+        else if (mid_ && k - 1 >= m) cut = advance(mid_, k - 1 - m);
+        else {
+            const std::size_t fm = (k - 1) / 2;
+            firstMid = advance(head_, fm);
+            cut = advance(firstMid, k - 1 - fm);
+            if (mid_) secondMid = advance(mid_, k + (sz_ - k - 1) / 2 - m);
         }
+        Node* head2 = cut ? cut->next : head_;
 
-        Node* slow = head_;
-        Node* fast = head_;
-        while (fast->next != head_ && fast->next->next != head_) {
-            slow = slow->next;
-            fast = fast->next->next;
+        if (k) {
+            first.head_ = head_; first.tail_ = cut; first.sz_ = k; first.mid_ = firstMid;
+            link(cut, head_);
         }
-        if (fast->next->next == head_) fast = fast->next; // even length → true tail
-
-        Node* head1 = head_;       Node* tail1 = slow;
-        Node* head2 = slow->next;  Node* tail2 = fast;
-
-        tail1->next = head1;
-        tail2->next = head2;
-
-        std::size_t n1 = (sz_ + 1) / 2;
-        std::size_t n2 = sz_ - n1;
-
-        first.head_ = head1; first.tail_ = tail1; first.sz_ = n1;
-        second.head_ = head2; second.tail_ = tail2; second.sz_ = n2;
+        if (k < sz_) {
+            second.head_ = head2; second.tail_ = tail_; second.sz_ = sz_ - k; second.mid_ = secondMid;
+            link(tail_, head2);
+        }
+        head_ = tail_ = mid_ = nullptr; sz_ = 0;
+#ifndef NDEBUG
+        first._checkInvariant();
+        second._checkInvariant();
+#endif
+    }
 
-        head_ = tail_ = nullptr; sz_ = 0;
+    // Split into parts.size() circular lists of consecutive elements, head
+    // first; the first size() % k parts get one extra. This list becomes
+    // empty. One walk finds the cut points; parts sharing our allocator get
+    // their run spliced in O(1), others get the elements moved over one by
+    // one (so e.g. each part can keep a pool of its own).
+    void splitIntoK(const std::vector<LinkedList*>& parts) {
+        for (LinkedList* p : parts) p->clear();
+        if (!head_ || parts.empty()) return;
+        ROBOT_RING_COUNT(Splits, 1);
+        ROBOT_RING_COUNT(SplitElements, sz_);
+        ROBOT_RING_MAX(SplitMax, sz_);
+        const std::size_t base = sz_ / parts.size(), extra = sz_ % parts.size();
+        Node* cur = head_;
+        for (std::size_t i = 0; i < parts.size(); ++i) {
+            LinkedList& p = *parts[i];
+            std::size_t n = base + (i < extra ? 1 : 0);
+            if (!n) continue;
+            if (p.alloc_ == alloc_) {
+                Node* t = cur;
+                for (std::size_t j = 1; j < n; ++j) t = t->next;
+                Node* nxt = t->next;
+                p.link_chain(cur, t, n);
+                cur = nxt;
+            } else {
+                for (std::size_t j = 0; j < n; ++j) {
+                    Node* nxt = cur->next;
+                    p.emplace_back(std::move(cur->data));
+                    destroy_node(cur);
+                    cur = nxt;
+                }
+            }
+        }
+        head_ = tail_ = mid_ = nullptr; sz_ = 0;
     }
 
     // Optional: splice another circle after this one in O(1); 'other' becomes empty.
-    void mergeWith(LinkedList<T>& other) {
+    // Splicing needs a shared allocator; with distinct pools the elements are
+    // moved over one by one instead (O(other.size())).
+    void mergeWith(LinkedList& other) {
         if (other.empty()) return;
+        ROBOT_RING_COUNT(Merges, 1);
+        ROBOT_RING_COUNT(MergeElements, other.sz_);
+        ROBOT_RING_MAX(MergeMax, other.sz_);
         if (empty()) {
-            head_ = other.head_; tail_ = other.tail_; sz_ = other.sz_;
-            other.head_ = other.tail_ = nullptr; other.sz_ = 0;
+            alloc_ = other.alloc_;              // we own no nodes; take theirs
+            head_ = other.head_; tail_ = other.tail_; sz_ = other.sz_; mid_ = other.mid_;
+            other.head_ = other.tail_ = other.mid_ = nullptr; other.sz_ = 0;
+            return;
+        }
+        if (!(alloc_ == other.alloc_)) {
+            ++gen_;
+            while (!other.empty()) {
+                append(std::move(other.front()));
+                other.pop_front();
+            }
             return;
         }
         Node* aHead = head_;
         Node* bHead = other.head_;
-        tail_->next = bHead;
-        other.tail_->next = aHead;
+        Node* aTail = tail_;
+        const std::size_t old = sz_;
+        link(tail_, bHead);
+        link(other.tail_, aHead);
         tail_ = other.tail_;
         sz_ += other.sz_;
-        other.head_ = other.tail_ = nullptr; other.sz_ = 0;
+        // New midpoint from the nearest anchor at or before it: our old tail
+        // (free when the halves of a split are merged back), other's
+        // midpoint, or ours; at most other.size()/2 steps
+        const std::size_t target = (sz_ - 1) / 2;
+        if (target >= old - 1) {
+            const std::size_t om = old + (other.sz_ - 1) / 2;
+            mid_ = (other.mid_ && target >= om) ? advance(other.mid_, target - om)
+                                                : advance(aTail, target - (old - 1));
+        } else if (mid_) {
+            mid_ = advance(mid_, target - (old - 1) / 2);
+        }
+        other.head_ = other.tail_ = other.mid_ = nullptr; other.sz_ = 0;
 #ifndef NDEBUG
         _checkInvariant();
 #endif
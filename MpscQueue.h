@@ -0,0 +1,59 @@
+// MpscQueue.h
+#pragma once
+#include <atomic>
+#include <optional>
+#include <utility>
+
+// Unbounded lock-free multi-producer single-consumer queue (Vyukov's
+// intrusive MPSC design). push() is one atomic exchange plus a store and
+// never blocks; pop() is called from one consumer thread only. Elements
+// come out in the order their pushes linearized (the exchange), so each
+// producer's own elements stay in order.
+//
+// A push that has exchanged but not yet linked its node can make pop()
+// report empty for a moment; the element shows up on a later pop().
+template <typename T>
+class MpscQueue {
+private:
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        std::optional<T> value;     // empty in the stub
+    };
+
+    std::atomic<Node*> head_;       // last pushed node (producers)
+    Node* tail_;                    // stub/last consumed node (consumer)
+
+public:
+    MpscQueue() : head_(new Node), tail_(head_.load(std::memory_order_relaxed)) {}
+    ~MpscQueue() {
+        while (tail_) {
+            Node* next = tail_->next.load(std::memory_order_relaxed);
+            delete tail_;
+            tail_ = next;
+        }
+    }
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // Any thread
+    void push(T value) {
+        Node* n = new Node;
+        n->value.emplace(std::move(value));
+        Node* prev = head_.exchange(n, std::memory_order_acq_rel);
+        prev->next.store(n, std::memory_order_release);
+    }
+
+    // Consumer thread only
+    bool pop(T& out) {
+        Node* next = tail_->next.load(std::memory_order_acquire);
+        if (!next) return false;
+        out = std::move(*next->value);
+        next->value.reset();        // next becomes the new stub
+        delete tail_;
+        tail_ = next;
+        return true;
+    }
+
+    // Consumer thread only; a hint, see the class comment
+    bool empty() const { return tail_->next.load(std::memory_order_acquire) == nullptr; }
+};
@@ -0,0 +1,150 @@
+// ParallelSim.h
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Simulation.h"
+
+// Fixed set of worker threads. run(jobs, f) calls f(i) exactly once for
+// every i in [0, jobs) spread over the workers and returns when all calls
+// have finished. Jobs are independent; which worker runs which job is not
+// specified.
+class WorkerPool {
+private:
+    std::vector<std::thread> threads_;
+    std::mutex m_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    std::function<void(std::size_t)> job_;
+    std::size_t jobs_ = 0;          // jobs in the current batch
+    std::size_t next_ = 0;          // next job to hand out
+    std::size_t pending_ = 0;       // jobs not finished yet
+    std::size_t batch_ = 0;         // bumped per run() to wake the workers
+    bool stop_ = false;
+
+    void work() {
+        std::size_t seen = 0;
+        std::unique_lock<std::mutex> lock(m_);
+        for (;;) {
+            wake_.wait(lock, [&] { return stop_ || batch_ != seen; });
+            if (stop_) return;
+            seen = batch_;
+            while (next_ < jobs_) {
+                std::size_t i = next_++;
+                lock.unlock();
+                job_(i);
+                lock.lock();
+                if (--pending_ == 0) done_.notify_all();
+            }
+        }
+    }
+
+public:
+    explicit WorkerPool(std::size_t threads) {
+        if (threads == 0) threads = 1;
+        threads_.reserve(threads);
+        for (std::size_t i = 0; i < threads; ++i) threads_.emplace_back([this] { work(); });
+    }
+    ~WorkerPool() {
+        { std::lock_guard<std::mutex> lock(m_); stop_ = true; }
+        wake_.notify_all();
+        for (std::thread& t : threads_) t.join();
+    }
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    std::size_t threads() const { return threads_.size(); }
+
+    void run(std::size_t jobs, std::function<void(std::size_t)> f) {
+        if (jobs == 0) return;
+        std::unique_lock<std::mutex> lock(m_);
+        job_ = std::move(f);
+        jobs_ = jobs; next_ = 0; pending_ = jobs;
+        ++batch_;
+        wake_.notify_all();
+        done_.wait(lock, [&] { return pending_ == 0; });
+        job_ = nullptr;
+    }
+};
+
+// Runs k sub-rings of one ring side by side, one job per sub-ring on a
+// WorkerPool owned by the simulation.
+//
+// Ordering/determinism contract:
+//  - split() cuts the ring into k runs of consecutive robots (ring order,
+//    the first size() % k runs one longer), as RobotRing::splitIntoK does;
+//  - run(n) advances every part by n ticks of its own round-robin
+//    (runTurns); parts never interact, so each part's result depends only on
+//    its robots and n, not on the thread count or on scheduling;
+//  - per-part TurnStats are kept in per-part slots and summed in part order;
+//    merge() appends the parts back in part order with mergeWith.
+// So split + run + merge gives the same ring and totals for any number of
+// threads (though not the same as running the unsplit ring, since each
+// part gets n ticks of its own).
+//
+// Each part owns a fresh allocator: with the default PoolAllocator the
+// node pool is not thread-safe, so split/merge move the robots (O(n))
+// instead of splicing nodes between pools.
+template <typename Ring>
+class ParallelSim {
+private:
+    WorkerPool pool_;
+    std::vector<std::unique_ptr<Ring>> parts_;
+    std::vector<TurnStats> stats_;  // slot i written only by part i's job
+
+public:
+    explicit ParallelSim(std::size_t threads = std::thread::hardware_concurrency())
+        : pool_(threads) {}
+
+    std::size_t threads() const { return pool_.threads(); }
+    std::size_t parts() const { return parts_.size(); }
+    const Ring& part(std::size_t i) const { return *parts_[i]; }
+    const TurnStats& partStats(std::size_t i) const { return stats_[i]; }
+
+    // Move ring's robots into k parts (k >= 1); ring becomes empty. Parts
+    // inherit ring's schedule mode. Parts left by an earlier split are
+    // merged back first.
+    void split(Ring& ring, std::size_t k) {
+        if (!parts_.empty()) merge(ring);
+        if (k == 0) k = 1;
+        std::vector<Ring*> raw;
+        for (std::size_t i = 0; i < k; ++i) {
+            parts_.push_back(std::make_unique<Ring>());
+            parts_.back()->setScheduleMode(ring.scheduleMode());
+            raw.push_back(parts_.back().get());
+        }
+        ring.splitIntoK(raw);
+        stats_.assign(k, TurnStats());
+    }
+
+    // Advance every part by n ticks in parallel; returns this run's totals
+    TurnStats run(long long n, TurnMode mode = TurnMode::FastForward) {
+        std::vector<TurnStats> step(parts_.size());
+        pool_.run(parts_.size(), [&](std::size_t i) {
+            step[i] = runTurns(*parts_[i], n, nullptr, mode);
+        });
+        TurnStats total;
+        for (std::size_t i = 0; i < step.size(); ++i) {
+            stats_[i] += step[i];
+            total += step[i];
+        }
+        return total;
+    }
+
+    // Append the parts to ring in part order and return the totals of every
+    // run() since split(). No parts are left afterwards.
+    TurnStats merge(Ring& ring) {
+        TurnStats total;
+        for (std::size_t i = 0; i < parts_.size(); ++i) {
+            ring.mergeWith(*parts_[i]);
+            total += stats_[i];
+        }
+        parts_.clear();
+        stats_.clear();
+        return total;
+    }
+};
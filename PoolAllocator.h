@@ -0,0 +1,128 @@
+// PoolAllocator.h
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+// Slab/free-list pool of fixed-size blocks (one list node per block).
+// Blocks are carved from contiguous chunks and recycled on deallocate, so a
+// ring that keeps appending and popping stops hitting the global heap once
+// the pool has warmed up. Not thread-safe; share it only between lists that
+// are used from the same thread.
+class NodePool {
+private:
+    struct FreeBlock { FreeBlock* next; };
+
+    static constexpr std::size_t kFirstChunk = 64;       // blocks in first chunk
+    static constexpr std::size_t kMaxChunk   = 1 << 16;  // cap on geometric growth
+
+    std::vector<void*> chunks_;     // owned raw chunks, freed in the destructor
+    FreeBlock* free_ = nullptr;     // intrusive free list threaded through blocks
+    std::size_t blockSize_ = 0;     // 0 until the first allocation binds it
+    std::size_t nextChunk_ = kFirstChunk;
+    std::size_t live_ = 0;          // blocks currently handed out
+    std::size_t capacity_ = 0;      // blocks carved so far
+
+    void grow(std::size_t blocks) {
+        char* mem = static_cast<char*>(::operator new(blocks * blockSize_));
+        chunks_.push_back(mem);
+        // thread the new blocks onto the free list in address order
+        for (std::size_t i = blocks; i-- > 0;) {
+            FreeBlock* b = reinterpret_cast<FreeBlock*>(mem + i * blockSize_);
+            b->next = free_;
+            free_ = b;
+        }
+        capacity_ += blocks;
+    }
+
+public:
+    NodePool() = default;
+    ~NodePool() { for (void* c : chunks_) ::operator delete(c); }
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    // True if a block of this shape comes from the pool. The first call binds
+    // the block size; later requests of a different shape go to the heap.
+    bool fits(std::size_t bytes, std::size_t align) {
+        if (align > alignof(std::max_align_t)) return false;
+        if (blockSize_ == 0) {
+            std::size_t a = align < alignof(FreeBlock) ? alignof(FreeBlock) : align;
+            std::size_t s = bytes < sizeof(FreeBlock) ? sizeof(FreeBlock) : bytes;
+            blockSize_ = (s + a - 1) / a * a;
+        }
+        return bytes <= blockSize_ && blockSize_ % align == 0;
+    }
+
+    void* allocate() {
+        if (!free_) {
+            grow(nextChunk_);
+            if (nextChunk_ < kMaxChunk) nextChunk_ *= 2;
+        }
+        FreeBlock* b = free_;
+        free_ = b->next;
+        ++live_;
+        return b;
+    }
+
+    void deallocate(void* p) noexcept {
+        FreeBlock* b = static_cast<FreeBlock*>(p);
+        b->next = free_;
+        free_ = b;
+        --live_;
+    }
+
+    // Make sure at least n blocks are free, carving the shortfall as a
+    // single chunk. Needs the block size bound (see fits()).
+    void reserve(std::size_t n) {
+        std::size_t free = capacity_ - live_;
+        if (blockSize_ && n > free) grow(n - free);
+    }
+
+    std::size_t live() const { return live_; }
+    std::size_t capacity() const { return capacity_; }
+};
+
+// Standard allocator front-end for NodePool. Copies (and rebinds) share the
+// same pool, so lists built from one allocator can exchange nodes freely.
+// A default-constructed allocator creates a fresh pool of its own.
+template <typename T>
+class PoolAllocator {
+private:
+    std::shared_ptr<NodePool> pool_;
+
+public:
+    using value_type = T;
+
+    PoolAllocator() : pool_(std::make_shared<NodePool>()) {}
+    explicit PoolAllocator(std::shared_ptr<NodePool> pool) : pool_(std::move(pool)) {}
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>& other) noexcept : pool_(other.pool()) {}
+
+    T* allocate(std::size_t n) {
+        if (n == 1 && pool_->fits(sizeof(T), alignof(T)))
+            return static_cast<T*>(pool_->allocate());
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+        if (n == 1 && pool_->fits(sizeof(T), alignof(T))) pool_->deallocate(p);
+        else ::operator delete(p);
+    }
+
+    // Room for n more single-object allocations of T without another chunk
+    void reserve(std::size_t n) {
+        if (pool_->fits(sizeof(T), alignof(T))) pool_->reserve(n);
+    }
+
+    const std::shared_ptr<NodePool>& pool() const noexcept { return pool_; }
+};
+
+template <typename T, typename U>
+bool operator==(const PoolAllocator<T>& a, const PoolAllocator<U>& b) noexcept {
+    return a.pool() == b.pool();
+}
+template <typename T, typename U>
+bool operator!=(const PoolAllocator<T>& a, const PoolAllocator<U>& b) noexcept {
+    return !(a == b);
+}
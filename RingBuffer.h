@@ -0,0 +1,353 @@
+// RingBuffer.h
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <cassert>
+
+// Array-backed alternative to LinkedList<T> with the same public API.
+// Elements live contiguously; the ring order is "slot head_ to the end, then
+// wrap to slot 0", skipping dead slots. rotate() is an index bump instead of
+// a pointer chase. pop_front() leaves a dead slot behind, and the array is
+// compacted once dead slots outnumber live ones, so the skips stay amortized
+// O(1). An append after rotations moves only the elements the head has
+// passed (those before head_) to the end of the array, which leaves dead
+// slots behind in the same way.
+//
+// Unlike LinkedList, splitIntoTwo and mergeWith move elements and are O(n).
+// They (and compaction) move whole runs of live slots with one range insert
+// each, which the standard library turns into a memmove when T is trivially
+// copyable (e.g. the compact Robot).
+template <typename T, typename Alloc = std::allocator<T>>
+class RingBuffer {
+private:
+    using FlagAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<unsigned char>;
+
+    std::vector<T, Alloc> buf_;                   // live and dead slots
+    std::vector<unsigned char, FlagAlloc> live_;  // 1 = slot holds a ring element
+    std::size_t head_ = 0;                        // slot of front(); meaningless when empty
+    std::size_t sz_ = 0;                          // live slots
+    std::size_t dead_ = 0;                        // dead slots still in buf_
+    std::size_t lo_ = 0;                          // slots [0, lo_) are dead; lo_ <= head_
+    std::size_t gen_ = 0;                         // bumped whenever slots move
+
+    std::size_t next_live(std::size_t i) const {
+        do { i = (i + 1 == buf_.size()) ? 0 : i + 1; } while (!live_[i]);
+        return i;
+    }
+
+    // Rebuild the array in ring order starting at slot 0; drops dead slots.
+    void compact() {
+        std::vector<T, Alloc> buf(buf_.get_allocator());
+        buf.reserve(sz_);
+        forEachRun([&](std::size_t i, std::size_t j) {
+            buf.insert(buf.end(), std::make_move_iterator(buf_.begin() + static_cast<std::ptrdiff_t>(i)),
+                       std::make_move_iterator(buf_.begin() + static_cast<std::ptrdiff_t>(j)));
+        });
+        buf_.swap(buf);
+        live_.assign(sz_, 1);
+        head_ = 0;
+        dead_ = 0;
+        lo_ = 0;
+        ++gen_;
+    }
+
+    // Make the array's end the logical tail: the live slots before head_
+    // (the last ones in ring order) move to the end, in order. That is one
+    // move per element the head has passed since the last call; the slots
+    // left behind are dead, and reclaimed by compaction as usual.
+    void openTail() {
+        if (head_ == lo_) return;
+        const std::size_t need = buf_.size() + (head_ - lo_) + 1;
+        if (buf_.capacity() < need) {             // grow geometrically, and before
+            const std::size_t cap = std::max(need, 2 * buf_.capacity());  // moving from buf_ itself
+            buf_.reserve(cap);
+            live_.reserve(cap);
+        }
+        std::size_t moved = 0;
+        for (std::size_t i = lo_; i < head_; ++i) {
+            if (!live_[i]) continue;
+            buf_.emplace_back(std::move(buf_[i]));
+            live_[i] = 0;
+            live_.push_back(1);
+            ++moved;
+        }
+        lo_ = head_;
+        if (!moved) return;
+        dead_ += moved;
+        ++gen_;
+        if (dead_ > sz_) compact();
+    }
+
+    // Visit live slots in ring order
+    template <typename F>
+    void forEachSlot(F&& f) const {
+        if (!sz_) return;
+        for (std::size_t i = head_; i < buf_.size(); ++i) if (live_[i]) f(i);
+        for (std::size_t i = 0; i < head_; ++i) if (live_[i]) f(i);
+    }
+
+    // Visit maximal runs [i, j) of live slots in ring order
+    template <typename F>
+    void forEachRun(F&& f) const {
+        if (!sz_) return;
+        auto scan = [&](std::size_t lo, std::size_t hi) {
+            while (lo < hi) {
+                while (lo < hi && !live_[lo]) ++lo;
+                std::size_t end = lo;
+                while (end < hi && live_[end]) ++end;
+                if (lo < end) f(lo, end);
+                lo = end;
+            }
+        };
+        scan(head_, buf_.size());
+        scan(0, head_);
+    }
+
+    // Move slots [i, j) onto dst's tail in one insert; dst's array must end
+    // at its tail (empty, or nothing live before head_: see openTail)
+    void moveRun(RingBuffer& dst, std::size_t i, std::size_t j) {
+        dst.buf_.insert(dst.buf_.end(), std::make_move_iterator(buf_.begin() + static_cast<std::ptrdiff_t>(i)),
+                        std::make_move_iterator(buf_.begin() + static_cast<std::ptrdiff_t>(j)));
+        dst.live_.insert(dst.live_.end(), j - i, 1);
+        dst.sz_ += j - i;
+    }
+
+    template <typename... Args>
+    T& place(Args&&... args) {
+        if (sz_ == 0) {
+            clear();
+        } else if (head_ != lo_) {                // the tail may be before head_
+            std::size_t slot = head_ - 1;         // just behind head == after tail
+            if (!live_[slot]) {
+                buf_[slot] = T(std::forward<Args>(args)...);
+                live_[slot] = 1;
+                --dead_; ++sz_;
+                _checkInvariant();
+                return buf_[slot];
+            }
+            openTail();                           // make the tail the array's end
+        }
+        buf_.emplace_back(std::forward<Args>(args)...);
+        live_.push_back(1);
+        ++sz_;
+        _checkInvariant();
+        return buf_.back();
+    }
+
+    void _checkInvariant() const {
+        assert(sz_ + dead_ == buf_.size() && live_.size() == buf_.size());
+        assert((sz_ == 0 || live_[head_]) && "head must be a live slot");
+        assert((sz_ == 0 ? lo_ == 0 : lo_ <= head_) && "live slot below lo_");
+    }
+
+public:
+    using allocator_type = Alloc;
+    // Slot index. Valid until the element is popped or generation() changes
+    // (compaction, clear, split and merge all move slots).
+    using handle = std::size_t;
+    static constexpr bool stable_handles = false;
+
+    RingBuffer() = default;
+    explicit RingBuffer(const Alloc& alloc) : buf_(alloc), live_(FlagAlloc(alloc)) {}
+    template <typename InputIt,
+              typename = std::enable_if_t<!std::is_integral<InputIt>::value>>
+    RingBuffer(InputIt first, InputIt last, const Alloc& alloc = Alloc())
+        : buf_(alloc), live_(FlagAlloc(alloc)) {
+        append_range(first, last);
+    }
+
+    allocator_type get_allocator() const { return buf_.get_allocator(); }
+
+    bool empty() const { return sz_ == 0; }
+    std::size_t size() const { return sz_; }
+
+    // ---- core operations ----
+
+    // Amortized O(1) append at the logical tail (just before head)
+    void append(const T& value) { place(value); }
+    void append(T&& value) { place(std::move(value)); }
+
+    // Construct in place at the tail (directly in the array when possible)
+    template <typename... Args>
+    T& emplace_back(Args&&... args) { return place(std::forward<Args>(args)...); }
+
+    // Bulk append in ring order; the tail is moved to the array's end at
+    // most once, then plain push_backs
+    template <typename InputIt>
+    void append_range(InputIt first, InputIt last) {
+        if (first == last) return;
+        if (sz_) openTail();
+        using Cat = typename std::iterator_traits<InputIt>::iterator_category;
+        if constexpr (std::is_base_of<std::forward_iterator_tag, Cat>::value)
+            reserve(sz_ + static_cast<std::size_t>(std::distance(first, last)));
+        if (!sz_) clear();
+        for (; first != last; ++first, ++sz_) {
+            buf_.emplace_back(*first);
+            live_.push_back(1);
+        }
+        _checkInvariant();
+    }
+
+    // Capacity for n elements without reallocating
+    void reserve(std::size_t n) {
+        buf_.reserve(n + dead_);
+        live_.reserve(n + dead_);
+    }
+
+    // Remove head; the slot is marked dead and reclaimed by compaction
+    bool pop_front() {
+        if (!sz_) return false;
+        live_[head_] = 0;
+        ++dead_; --sz_;
+        if (!sz_) { clear(); return true; }
+        head_ = next_live(head_);
+        if (dead_ > sz_) compact();
+        _checkInvariant();
+        return true;
+    }
+
+    // Remove the element at slot h; like pop_front it leaves a dead slot
+    // (amortized O(1), may compact)
+    void erase(handle h) {
+        if (h == head_) { pop_front(); return; }
+        live_[h] = 0;
+        ++dead_; --sz_;
+        if (dead_ > sz_) compact();
+        _checkInvariant();
+    }
+
+    // Construct an element right after h in ring order. The array is
+    // compacted into ring order and the later elements shift up one slot,
+    // so this is O(n) (after the tail it is a plain append). Returns the
+    // new slot.
+    template <typename... Args>
+    handle emplace_after(handle h, Args&&... args) {
+        if (h == back_handle()) { place(std::forward<Args>(args)...); return back_handle(); }
+        std::size_t rank = 0;                     // h's position in ring order
+        for (std::size_t i = head_; i != h; i = next_live(i)) ++rank;
+        compact();
+        buf_.emplace(buf_.begin() + static_cast<std::ptrdiff_t>(rank + 1), std::forward<Args>(args)...);
+        live_.push_back(1);
+        ++sz_;
+        _checkInvariant();
+        return rank + 1;
+    }
+    handle insert_after(handle h, const T& value) { return emplace_after(h, value); }
+    handle insert_after(handle h, T&& value) { return emplace_after(h, std::move(value)); }
+
+    // Rotate one step: head moves to the next live slot
+    void rotate() {
+        if (sz_ < 2) return;
+        head_ = next_live(head_);
+    }
+
+    // Access head element (assumes non-empty)
+    T& front() { return buf_[head_]; }
+    const T& front() const { return buf_[head_]; }
+
+    // Handle access (assumes non-empty)
+    handle front_handle() const { return head_; }
+    handle back_handle() const {
+        std::size_t i = head_;
+        do { i = (i == 0) ? buf_.size() - 1 : i - 1; } while (!live_[i]);
+        return i;
+    }
+    T& at(handle h) { return buf_[h]; }
+    const T& at(handle h) const { return buf_[h]; }
+    std::size_t generation() const { return gen_; }
+
+    // Visit (handle, element) pairs in ring order
+    template <typename F>
+    void forEachHandle(F&& f) {
+        forEachSlot([&](std::size_t i) { f(i, buf_[i]); });
+    }
+
+    // Same format as LinkedList::display
+    void display() const {
+        if (!sz_) { std::cout << "[] (empty)\n"; return; }
+        std::cout << "[";
+        std::size_t printed = 0;
+        forEachSlot([&](std::size_t i) {
+            std::cout << buf_[i];
+            if (++printed < sz_) std::cout << " -> ";
+        });
+        std::cout << "] (circular)\n";
+    }
+
+    template <typename F>
+    void forEach(F&& f) const {
+        forEachSlot([&](std::size_t i) { f(buf_[i]); });
+    }
+
+    // Mutable variant, head first
+    template <typename F>
+    void forEach(F&& f) {
+        forEachSlot([&](std::size_t i) { f(buf_[i]); });
+    }
+
+    void clear() {
+        buf_.clear();
+        live_.clear();
+        head_ = sz_ = dead_ = lo_ = 0;
+        ++gen_;
+    }
+
+    // ---- split & merge ----
+
+    // first gets ceil(n/2), second gets floor(n/2). This ring becomes empty.
+    void splitIntoTwo(RingBuffer& first, RingBuffer& second) {
+        splitIntoK({&first, &second});
+    }
+
+    // Split into parts.size() rings of consecutive elements, head first; the
+    // first size() % k parts get one extra. This ring becomes empty.
+    void splitIntoK(const std::vector<RingBuffer*>& parts) {
+        for (RingBuffer* p : parts) p->clear();
+        if (!sz_ || parts.empty()) return;
+        const std::size_t base = sz_ / parts.size(), extra = sz_ % parts.size();
+        std::size_t part = 0, left = base + (extra ? 1 : 0);
+        parts[0]->reserve(left);
+        forEachRun([&](std::size_t i, std::size_t j) {
+            while (i < j) {
+                while (!left) {
+                    ++part;
+                    left = base + (part < extra ? 1 : 0);
+                    parts[part]->reserve(left);
+                }
+                const std::size_t take = std::min(left, j - i);
+                moveRun(*parts[part], i, i + take);
+                i += take;
+                left -= take;
+            }
+        });
+        for (RingBuffer* p : parts) p->_checkInvariant();
+        clear();
+    }
+
+    // Append other's elements after our tail; 'other' becomes empty.
+    void mergeWith(RingBuffer& other) {
+        if (other.empty()) return;
+        if (empty()) {
+            buf_.swap(other.buf_);
+            live_.swap(other.live_);
+            std::swap(head_, other.head_);
+            std::swap(sz_, other.sz_);
+            std::swap(dead_, other.dead_);
+            std::swap(lo_, other.lo_);
+            ++gen_;
+            other.clear();
+            return;
+        }
+        openTail();
+        reserve(sz_ + other.sz_);
+        other.forEachRun([&](std::size_t i, std::size_t j) { other.moveRun(*this, i, j); });
+        other.clear();
+        _checkInvariant();
+    }
+};
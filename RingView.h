@@ -0,0 +1,120 @@
+// RingView.h
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <string_view>
+#include <vector>
+#include "Robot.h"
+#include "RobotRing.h"
+#include "Simulation.h"
+#include "Snapshot.h"
+
+// Immutable copy of a ring taken between ticks: the rotation in ring order
+// (head first), the parked robots, aggregates and the counters at that
+// point. Any number of threads may read one at once.
+//
+// Names are captured as views at publish time: with -DROBOT_COMPACT,
+// robotName() reads the NameTable, which the simulation thread may be
+// growing, so readers on other threads use name()/parkedName() instead.
+struct RingView {
+    std::vector<Robot> robots;      // rotation, head first
+    std::vector<Robot> parked;
+    std::vector<std::string_view> names;        // parallel to robots
+    std::vector<std::string_view> parkedNames;  // parallel to parked
+    FleetStats stats;
+    long long ticks = 0;
+    long long score = 0;
+    std::size_t version = 0;        // 1 for the first publish, then +1
+
+    std::size_t size() const { return robots.size(); }
+    std::size_t robotCount() const { return robots.size() + parked.size(); }
+    std::string_view name(std::size_t i) const { return names[i]; }
+    std::string_view parkedName(std::size_t i) const { return parkedNames[i]; }
+
+    template <typename F>
+    void forEach(F&& f) const { for (const Robot& r : robots) f(r); }
+    template <typename F>
+    void forEachParked(F&& f) const { for (const Robot& r : parked) f(r); }
+
+    // Same text as the live ring's display()
+    void display(std::ostream& os = std::cout) const {
+        auto put = [&](std::string_view name, const Robot& r) {
+            os << "Robot(" << name << ", Battery=" << r.battery << ")";
+        };
+        if (robots.empty()) os << "[] (empty)\n";
+        else {
+            os << "[";
+            for (std::size_t i = 0; i < robots.size(); ++i) {
+                if (i) os << " -> ";
+                put(names[i], robots[i]);
+            }
+            os << "] (circular)\n";
+        }
+        if (parked.empty()) return;
+        os << "Parked: [";
+        for (std::size_t i = 0; i < parked.size(); ++i) {
+            if (i) os << ", ";
+            put(parkedNames[i], parked[i]);
+        }
+        os << "]\n";
+    }
+};
+
+// RCU-style publication of RingViews. The simulation thread copies the ring
+// into a fresh view between ticks and swaps it in; readers (monitoring,
+// display, stats) grab the current view and iterate it without locks and
+// without ever touching the live ring, so rotate/pop_front never wait on
+// them. A view is freed when its last reader lets go of it, which is the
+// grace period: nodes popped from the live ring are never reachable from a
+// view, so they can go back to the pool immediately.
+class ViewPublisher {
+private:
+    std::shared_ptr<const RingView> current_;   // atomic_load/atomic_store only
+    std::size_t version_ = 0;                   // writer side
+
+public:
+    ViewPublisher() : current_(std::make_shared<const RingView>()) {}
+
+    // Simulation thread: O(ring size) copy, then one atomic swap
+    template <typename Ring>
+    void publish(const Ring& ring, long long ticks, long long score) {
+        auto v = std::make_shared<RingView>();
+        v->robots.reserve(ring.size());
+        v->names.reserve(ring.size());
+        ring.forEach([&](const Robot& r) { v->robots.push_back(r); v->stats.add(r); });
+        snapshot::forEachParked(ring, [&](const Robot& r) { v->parked.push_back(r); v->stats.add(r); }, 0);
+        // name views into the view's own copies (or the interned arena)
+        for (const Robot& r : v->robots) v->names.push_back(robotName(r));
+        for (const Robot& r : v->parked) v->parkedNames.push_back(robotName(r));
+        v->ticks = ticks;
+        v->score = score;
+        v->version = ++version_;
+        std::atomic_store_explicit(&current_, std::shared_ptr<const RingView>(std::move(v)),
+                                   std::memory_order_release);
+    }
+
+    // Any thread: the latest view; stays valid for as long as it is held
+    std::shared_ptr<const RingView> current() const {
+        return std::atomic_load_explicit(&current_, std::memory_order_acquire);
+    }
+};
+
+// runTurns in slices of `every` ticks, publishing a view after each slice.
+// ticks/score are the totals before this call (the view shows running totals).
+template <typename Ring>
+TurnStats runTurnsPublishing(Ring& ring, long long n, ViewPublisher& pub, long long every,
+                             long long ticks = 0, long long score = 0,
+                             TurnMode mode = TurnMode::Step) {
+    TurnStats st;
+    if (every < 1) every = 1;
+    while (st.ticks < n) {
+        TurnStats s = runTurns(ring, std::min(every, n - st.ticks), nullptr, mode);
+        st += s;
+        pub.publish(ring, ticks + st.ticks, score + st.score);
+        if (s.ticks == 0) break;
+    }
+    return st;
+}
@@ -0,0 +1,150 @@
+// Robot.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Interned robot names. Each distinct name is stored once in an append-only
+// arena and referred to by a 32-bit NameId; views returned by view() stay
+// valid for the life of the table. Not thread-safe: intern from the
+// simulation thread only.
+using NameId = std::uint32_t;
+
+class NameTable {
+private:
+    static constexpr std::size_t kChunk = 64 * 1024;
+
+    std::vector<std::unique_ptr<char[]>> chunks_;
+    std::size_t used_ = 0;                            // bytes used in chunks_.back()
+    std::vector<std::string_view> names_;             // NameId -> text in the arena
+    // Open-addressing lookup, linear probing: (hash << 32 | id) per slot, 0 = empty.
+    // Keeping the hash in the slot skips most string compares.
+    std::vector<std::uint64_t> slots_;
+
+    static std::uint32_t hashOf(std::string_view s) {
+        std::uint32_t h = 2166136261u;                // FNV-1a
+        for (unsigned char c : s) { h ^= c; h *= 16777619u; }
+        return h;
+    }
+
+    void rehash(std::size_t want) {
+        std::vector<std::uint64_t> old;
+        old.swap(slots_);
+        slots_.assign(want, 0);
+        for (std::uint64_t e : old) if (e) place(e);
+    }
+
+    void place(std::uint64_t e) {
+        std::size_t mask = slots_.size() - 1;
+        std::size_t i = static_cast<std::size_t>(e >> 32) & mask;
+        while (slots_[i]) i = (i + 1) & mask;
+        slots_[i] = e;
+    }
+
+    std::string_view store(std::string_view s) {
+        if (s.empty()) return {};
+        if (s.size() > kChunk) {                      // oversized: a chunk of its own,
+            std::unique_ptr<char[]> big(new char[s.size()]);  // kept before the open one
+            s.copy(big.get(), s.size());
+            std::string_view v(big.get(), s.size());
+            chunks_.insert(chunks_.empty() ? chunks_.end() : chunks_.end() - 1, std::move(big));
+            return v;
+        }
+        if (chunks_.empty() || kChunk - used_ < s.size()) {
+            chunks_.emplace_back(new char[kChunk]);
+            used_ = 0;
+        }
+        char* dst = chunks_.back().get() + used_;
+        s.copy(dst, s.size());
+        used_ += s.size();
+        return {dst, s.size()};
+    }
+
+public:
+    NameTable() { intern(""); }                       // NameId 0 is the empty name
+    NameTable(const NameTable&) = delete;
+    NameTable& operator=(const NameTable&) = delete;
+
+    NameId intern(std::string_view s) {
+        const std::uint32_t h = hashOf(s);
+        if (!slots_.empty()) {
+            std::size_t mask = slots_.size() - 1;
+            for (std::size_t i = h & mask; slots_[i]; i = (i + 1) & mask) {
+                if (static_cast<std::uint32_t>(slots_[i] >> 32) != h) continue;
+                NameId id = static_cast<NameId>(slots_[i] - 1);
+                if (names_[id] == s) return id;
+            }
+        }
+        if ((names_.size() + 1) * 2 > slots_.size())  // keep load <= 1/2
+            rehash(slots_.empty() ? 64 : slots_.size() * 2);
+        NameId id = static_cast<NameId>(names_.size());
+        names_.push_back(store(s));
+        place((static_cast<std::uint64_t>(h) << 32) | (static_cast<std::uint64_t>(id) + 1));
+        return id;
+    }
+
+    // Room for n distinct names without rehashing
+    void reserve(std::size_t n) {
+        names_.reserve(n);
+        std::size_t want = 64;
+        while (want < n * 2) want *= 2;
+        if (want > slots_.size()) rehash(want);
+    }
+
+    std::string_view view(NameId id) const { return names_[id]; }
+    std::size_t size() const { return names_.size(); }
+
+    // Process-wide table used by the compact Robot
+    static NameTable& global() {
+        static NameTable table;
+        return table;
+    }
+};
+
+#ifdef ROBOT_COMPACT
+// Compact layout (16 bytes): the name is an interned NameId and drain shares
+// a word with the paused bit, so drain is limited to 31 bits. Select with
+// -DROBOT_COMPACT; the field names match the default layout except the name,
+// which is read through robotName().
+struct Robot {
+    using NameArg = std::string_view;   // what loaders pass as the name
+
+    std::int32_t id;
+    std::int32_t battery;   // remaining
+    std::int32_t drain : 31;   // per turn (Quantum)
+    std::uint32_t paused : 1;
+    NameId nameId;
+
+    Robot(int id_, std::string_view n, int b, int d = 1, bool p = false)
+        : id(id_), battery(b), drain(d), paused(p), nameId(NameTable::global().intern(n)) {}
+};
+
+static_assert(sizeof(Robot) == 16, "compact Robot should stay 16 bytes");
+
+inline std::string_view robotName(const Robot& r) { return NameTable::global().view(r.nameId); }
+#else
+struct Robot {
+    using NameArg = std::string;        // what loaders pass as the name
+
+    int id;
+    std::string name;
+    int battery;   // remaining
+    int drain;     // per turn (Quantum)
+    bool paused;
+
+    Robot(int id_, std::string n, int b, int d = 1, bool p = false)
+        : id(id_), name(std::move(n)), battery(b), drain(d), paused(p) {}
+};
+
+inline std::string_view robotName(const Robot& r) { return r.name; }
+#endif
+
+inline std::ostream& operator<<(std::ostream& os, const Robot& r) {
+    os << "Robot(" << robotName(r) << ", Battery=" << r.battery << ")";
+    return os;
+}
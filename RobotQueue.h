@@ -0,0 +1,65 @@
+// RobotQueue.h
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <vector>
+#include "MpscQueue.h"
+#include "Robot.h"
+#include "Simulation.h"
+
+// A robot registered by an outside producer. It has no id yet: ids are
+// handed out by the simulation thread when the robot joins the ring, so
+// they stay dense and in join order.
+struct PendingRobot {
+    std::string name;
+    int battery = 0;
+    int drain = 1;
+    bool paused = false;
+};
+
+// Producers push from any thread; only the simulation thread drains.
+using RobotQueue = MpscQueue<PendingRobot>;
+
+// Move up to limit queued robots into ring with one append_range, ids from
+// nextId in queue order. Simulation thread only; call between ticks.
+// Returns how many joined.
+template <typename Ring>
+std::size_t ingestPending(RobotQueue& queue, Ring& ring, int& nextId,
+                          std::size_t limit = std::numeric_limits<std::size_t>::max()) {
+    if (queue.empty()) return 0;
+    std::vector<Robot> batch;
+    PendingRobot p;
+    while (batch.size() < limit && queue.pop(p))
+        batch.emplace_back(nextId++, Robot::NameArg(p.name), p.battery, p.drain, p.paused);
+    ring.reserve(ring.size() + batch.size());
+    ring.append_range(std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+    return batch.size();
+}
+
+struct IngestStats {
+    TurnStats turns;
+    std::size_t joined = 0;         // robots taken from the queue
+};
+
+// runTurns in slices of `every` ticks, draining the queue before each slice
+// (and once more at the end), so newcomers join on tick boundaries in
+// batches and producers never wait on the ring. Stops early once a slice
+// finds nothing to run. Tick events go to sink (none by default).
+template <typename Ring, typename Sink = StreamSink>
+IngestStats runTurnsIngesting(Ring& ring, long long n, RobotQueue& queue, int& nextId,
+                              long long every, TurnMode mode = TurnMode::Step,
+                              Sink&& sink = Sink()) {
+    IngestStats st;
+    if (every < 1) every = 1;
+    while (st.turns.ticks < n) {
+        st.joined += ingestPending(queue, ring, nextId);
+        TurnStats s = runTurns(ring, std::min(every, n - st.turns.ticks), sink, mode);
+        st.turns += s;
+        if (s.ticks == 0) break;    // nothing left to run
+    }
+    st.joined += ingestPending(queue, ring, nextId);
+    return st;
+}
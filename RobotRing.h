@@ -0,0 +1,480 @@
+// RobotRing.h
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "LinkedList.h"
+#include "Robot.h"
+
+// Running aggregates over a set of robots. Every update is O(1) and
+// allocation-free. Sum, counts and average are always exact. Min/max follow
+// adds and drains directly, but a removal or drain of the robot at either
+// bound only marks them stale (boundsStale()); the owner then re-derives
+// them with rebound() when they are read, so reports never need a walk
+// unless the bounds actually moved.
+class FleetStats {
+private:
+    long long sum_ = 0;
+    std::size_t count_ = 0;
+    std::size_t paused_ = 0;
+    int min_ = 0;
+    int max_ = 0;
+    bool stale_ = false;            // min_/max_ are only outer bounds
+
+    void include(int b) {
+        if (count_ == 1) { min_ = max_ = b; stale_ = false; return; }
+        if (b < min_) min_ = b;
+        if (b > max_) max_ = b;
+    }
+    void exclude(int b) {
+        if (count_ == 0) { min_ = max_ = 0; stale_ = false; return; }
+        if (b == min_ || b == max_) stale_ = true;
+    }
+
+public:
+    void add(const Robot& r) {
+        sum_ += r.battery; ++count_; paused_ += r.paused; include(r.battery);
+    }
+    void remove(const Robot& r) {
+        sum_ -= r.battery; --count_; paused_ -= r.paused; exclude(r.battery);
+    }
+    void batteryChanged(int before, int after) {
+        if (before == after) return;
+        sum_ += static_cast<long long>(after) - before;
+        if (after < before) {                   // a drain: min follows, max may drop
+            if (before == max_) stale_ = true;
+            if (after < min_) min_ = after;
+        } else {
+            if (before == min_) stale_ = true;
+            if (after > max_) max_ = after;
+        }
+    }
+    // Several batteries changed by delta in all; bounds are re-derived later
+    void batteriesChanged(long long delta) {
+        if (!delta) return;
+        sum_ += delta;
+        stale_ = true;
+    }
+    void pauseChanged(bool paused) { if (paused) ++paused_; else --paused_; }
+
+    // Take over other's robots; other becomes empty
+    void merge(FleetStats& other) {
+        if (other.count_) {
+            if (!count_) { min_ = other.min_; max_ = other.max_; stale_ = other.stale_; }
+            else {
+                min_ = std::min(min_, other.min_);
+                max_ = std::max(max_, other.max_);
+                stale_ = stale_ || other.stale_;
+            }
+        }
+        sum_ += other.sum_; count_ += other.count_; paused_ += other.paused_;
+        other.clear();
+    }
+    void clear() { sum_ = 0; count_ = paused_ = 0; min_ = max_ = 0; stale_ = false; }
+
+    // Re-derive min/max; forEach(f) must call f(robot) for every robot
+    bool boundsStale() const { return stale_; }
+    template <typename ForEach>
+    void rebound(ForEach&& forEach) {
+        bool first = true;
+        forEach([&](const Robot& r) {
+            if (first) { min_ = max_ = r.battery; first = false; return; }
+            if (r.battery < min_) min_ = r.battery;
+            if (r.battery > max_) max_ = r.battery;
+        });
+        if (first) min_ = max_ = 0;
+        stale_ = false;
+    }
+
+    std::size_t count() const { return count_; }
+    std::size_t paused() const { return paused_; }
+    std::size_t active() const { return count_ - paused_; }
+    long long batterySum() const { return sum_; }
+    // Exact unless boundsStale() (RobotRing::stats() refreshes them)
+    int minBattery() const { return min_; }
+    int maxBattery() const { return max_; }
+    double avgBattery() const { return count_ ? static_cast<double>(sum_) / count_ : 0.0; }
+};
+
+// Robot ring with an id -> element index on top of a ring engine
+// (LinkedList or RingBuffer). Lookups by id are O(1) and never rotate the
+// ring, so scheduling order is left alone. The index follows pop_front,
+// splitIntoTwo and mergeWith.
+//
+// Engines whose handles move (RingBuffer compaction) are detected through
+// generation(); the index is then rebuilt lazily on the next lookup.
+// Battery and pause changes go through drainFront()/setPaused() (or the
+// mutable forEach, which re-tallies afterwards) so stats() stays exact.
+//
+// ScheduleMode::Parked takes paused robots out of the rotation so ticks only
+// ever land on active robots: a paused robot is moved to a side table when it
+// next reaches the head (settleFront), and rejoins at the tail on resume.
+// Skips then cost and score nothing. ScheduleMode::Inline (the default) keeps
+// the original rules: a paused robot stays in place and uses up a tick.
+// size(), front(), forEach() etc. cover the rotation only; parked robots are
+// reached through parkedCount()/forEachParked().
+//
+// revision() changes on every change to membership, battery or pause state
+// (not on rotate), so schedulers keeping their own order (Scheduler.h) can
+// tell when to rebuild it.
+enum class ScheduleMode { Inline, Parked };
+
+template <typename Engine = LinkedList<Robot>>
+class RobotRing {
+private:
+    using handle = typename Engine::handle;
+
+    Engine ring_;
+    std::unordered_map<int, handle> index_;
+    std::size_t indexGen_ = 0;      // engine generation the index matches
+    bool stale_ = false;            // index must be rebuilt before use
+    ScheduleMode mode_ = ScheduleMode::Inline;
+    std::map<int, Robot> parked_;   // by id, so unparking order is deterministic
+    mutable FleetStats stats_;      // rotation + parked; stats() refreshes its bounds
+    std::size_t rev_ = 0;           // see revision()
+
+    void sync() {
+        if (!stale_ && indexGen_ == ring_.generation()) return;
+        index_.clear();
+        index_.reserve(ring_.size());
+        ring_.forEachHandle([&](handle h, const Robot& r) { index_[r.id] = h; });
+        indexGen_ = ring_.generation();
+        stale_ = false;
+    }
+
+    void markStale() { stale_ = true; }
+    void touch() { ++rev_; }
+
+    void unparkAll() {
+        if (!parked_.empty()) touch();
+        for (auto& e : parked_) link(std::move(e.second));
+        parked_.clear();
+    }
+
+    void retally() {
+        touch();
+        stats_.clear();
+        ring_.forEach([&](const Robot& r) { stats_.add(r); });
+        for (const auto& e : parked_) stats_.add(e.second);
+    }
+
+    // Move into / out of the rotation without touching stats_
+    template <typename R>
+    void link(R&& r) { touch(); ring_.append(std::forward<R>(r)); indexBack(); }
+    void unlinkFront() {
+        touch();
+        sync();
+        index_.erase(ring_.front().id);
+        ring_.pop_front();
+    }
+
+    // Index the element just appended, unless the append moved slots
+    void indexBack() {
+        if (stale_ || indexGen_ != ring_.generation()) { markStale(); return; }
+        handle h = ring_.back_handle();
+        index_[ring_.at(h).id] = h;
+    }
+
+public:
+    using allocator_type = typename Engine::allocator_type;
+
+    RobotRing() = default;
+    explicit RobotRing(const allocator_type& alloc) : ring_(alloc) {}
+
+    allocator_type get_allocator() const { return ring_.get_allocator(); }
+
+    bool empty() const { return ring_.empty(); }
+    std::size_t size() const { return ring_.size(); }
+
+    // ---- engine operations, index kept in step ----
+
+    void append(const Robot& r) { stats_.add(r); link(r); }
+    void append(Robot&& r) { stats_.add(r); link(std::move(r)); }
+
+    // Robot constructed in place at the tail
+    template <typename... Args>
+    const Robot& emplace_back(Args&&... args) {
+        const Robot& r = ring_.emplace_back(std::forward<Args>(args)...);
+        touch();
+        stats_.add(r);
+        indexBack();
+        return r;
+    }
+
+    // Bulk load through the engine's single-pass append_range (any input
+    // iterator) when the ring is empty: stats are tallied in one walk and
+    // the index is rebuilt on the next lookup. Onto a non-empty ring each
+    // robot is tallied and indexed as it is linked, so a small batch costs
+    // its own size rather than the ring's.
+    template <typename InputIt>
+    void append_range(InputIt first, InputIt last) {
+        if (!ring_.empty() || !parked_.empty()) {
+            for (; first != last; ++first) append(*first);
+            return;
+        }
+        ring_.append_range(first, last);
+        markStale();
+        retally();
+    }
+
+    // Room for n robots in the rotation in all
+    void reserve(std::size_t n) { ring_.reserve(n); index_.reserve(n); }
+
+    bool pop_front() {
+        if (ring_.empty()) return false;
+        stats_.remove(ring_.front());
+        unlinkFront();
+        return true;
+    }
+
+    void rotate() { ring_.rotate(); }
+
+    // Read-only: mutate through drainFront/setPaused/forEach
+    const Robot& front() const { return ring_.front(); }
+
+    // Drain every robot in the rotation full times, and the first part of
+    // them (ring order) once more: fastForward's closed-form jump. O(n) with
+    // the stats adjusted by the total instead of re-tallied.
+    void drainAll(long long full, long long part) {
+        long long i = 0, delta = 0;
+        ring_.forEach([&](Robot& r) {
+            const long long d = (full + (i++ < part ? 1 : 0)) * r.drain;
+            r.battery = static_cast<int>(r.battery - d);
+            delta -= d;
+        });
+        stats_.batteriesChanged(delta);
+        touch();
+    }
+
+    // Apply the head robot's drain; returns its new battery
+    int drainFront() {
+        Robot& r = ring_.front();
+        int before = r.battery;
+        r.battery -= r.drain;
+        stats_.batteryChanged(before, r.battery);
+        touch();
+        return r.battery;
+    }
+
+    // Apply one robot's drain by id, wherever it sits in the rotation;
+    // returns the robot or nullptr if it is not in the rotation
+    const Robot* drain(int id) {
+        sync();
+        auto it = index_.find(id);
+        if (it == index_.end()) return nullptr;
+        Robot& r = ring_.at(it->second);
+        int before = r.battery;
+        r.battery -= r.drain;
+        stats_.batteryChanged(before, r.battery);
+        touch();
+        return &r;
+    }
+
+    // Put r into the rotation right after robot `after` (so it runs next
+    // once that robot has had its turn); nullptr if `after` is not in the
+    // rotation. O(1) on LinkedList, O(n) on RingBuffer.
+    const Robot* insert_after(int after, Robot r) {
+        sync();
+        auto it = index_.find(after);
+        if (it == index_.end()) return nullptr;
+        const std::size_t gen = ring_.generation();
+        const int id = r.id;
+        stats_.add(r);
+        handle h = ring_.insert_after(it->second, std::move(r));
+        if (gen == ring_.generation()) index_[id] = h;
+        else markStale();
+        touch();
+        return &ring_.at(h);
+    }
+
+    // Remove a robot by id from the rotation or the parked table, out of
+    // turn; false if unknown. O(1) on a DoublyLinked LinkedList, amortized
+    // O(1) on RingBuffer, a walk to the predecessor on a SinglyLinked one.
+    bool erase(int id) {
+        sync();
+        auto it = index_.find(id);
+        if (it != index_.end()) {
+            stats_.remove(ring_.at(it->second));
+            ring_.erase(it->second);
+            index_.erase(it);
+            touch();
+            return true;
+        }
+        auto p = parked_.find(id);
+        if (p == parked_.end()) return false;
+        stats_.remove(p->second);
+        parked_.erase(p);
+        touch();
+        return true;
+    }
+
+    // Aggregates over every robot (rotation and parked). O(1) to read, plus
+    // one walk when a removal or drain has left min/max stale since the
+    // last read.
+    const FleetStats& stats() const {
+        if (stats_.boundsStale()) {
+            stats_.rebound([&](auto&& f) {
+                ring_.forEach(f);
+                for (const auto& e : parked_) f(e.second);
+            });
+        }
+        return stats_;
+    }
+    std::size_t revision() const { return rev_; }
+
+    void display() const {
+        ring_.display();
+        if (parked_.empty()) return;
+        std::cout << "Parked: [";
+        const char* sep = "";
+        for (const auto& e : parked_) { std::cout << sep << e.second; sep = ", "; }
+        std::cout << "]\n";
+    }
+
+    template <typename F>
+    void forEach(F&& f) const { ring_.forEach(std::forward<F>(f)); }
+    // Mutable walk for bulk updates; stats are re-tallied afterwards (O(n))
+    template <typename F>
+    void forEach(F&& f) { ring_.forEach(std::forward<F>(f)); retally(); }
+
+    void clear() {
+        ring_.clear(); index_.clear(); stale_ = false; indexGen_ = ring_.generation();
+        parked_.clear(); stats_.clear();
+        touch();
+    }
+
+    // O(1) average lookup (parked robots: O(log p)); nullptr if unknown id
+    const Robot* find(int id) { return findMut(id); }
+
+    // Pause or resume by id; returns the robot (which may have moved) or
+    // nullptr if unknown. Resuming a parked robot appends it at the tail.
+    const Robot* setPaused(int id, bool paused) {
+        auto p = parked_.find(id);
+        if (p == parked_.end()) {
+            Robot* r = findMut(id);
+            if (r && r->paused != paused) { r->paused = paused; stats_.pauseChanged(paused); touch(); }
+            return r;
+        }
+        if (paused) return &p->second;
+        Robot r = std::move(p->second);
+        parked_.erase(p);
+        r.paused = false;
+        stats_.pauseChanged(false);
+        link(std::move(r));
+        return &ring_.at(ring_.back_handle());
+    }
+
+private:
+    Robot* findMut(int id) {
+        sync();
+        auto it = index_.find(id);
+        if (it != index_.end()) return &ring_.at(it->second);
+        auto p = parked_.find(id);
+        return p == parked_.end() ? nullptr : &p->second;
+    }
+
+public:
+    // ---- parking ----
+
+    ScheduleMode scheduleMode() const { return mode_; }
+    bool parking() const { return mode_ == ScheduleMode::Parked; }
+
+    // Leaving Parked mode puts every parked robot back at the tail (by id)
+    void setScheduleMode(ScheduleMode mode) {
+        mode_ = mode;
+        if (mode_ == ScheduleMode::Inline) unparkAll();
+    }
+
+    // Park paused robots sitting at the head until an active one is there.
+    // Each robot is parked once, so this is amortized O(1) per tick.
+    void settleFront() {
+        if (mode_ != ScheduleMode::Parked) return;
+        while (!ring_.empty() && ring_.front().paused) {
+            int id = ring_.front().id;
+            parked_.emplace(id, std::move(ring_.front()));
+            unlinkFront();
+        }
+    }
+
+    std::size_t parkedCount() const { return parked_.size(); }
+    std::size_t robotCount() const { return ring_.size() + parked_.size(); }
+
+    template <typename F>
+    void forEachParked(F&& f) const { for (const auto& e : parked_) f(e.second); }
+
+    // first gets ceil(n/2), second gets floor(n/2); whatever they held
+    // before (parked robots included) is dropped. This ring becomes empty.
+    // The index entries of the second half are moved over (O(n/2)).
+    // Parked robots rejoin the rotation first. Stats are re-tallied (O(n)).
+    void splitIntoTwo(RobotRing& first, RobotRing& second) {
+        first.clear(); second.clear();
+        unparkAll();
+        sync();
+        ring_.splitIntoTwo(first.ring_, second.ring_);
+        first.index_.clear(); second.index_.clear();
+        if constexpr (Engine::stable_handles) {
+            first.index_.swap(index_);
+            second.ring_.forEachHandle([&](handle h, const Robot& r) {
+                first.index_.erase(r.id);
+                second.index_[r.id] = h;
+            });
+            first.indexGen_ = first.ring_.generation(); first.stale_ = false;
+            second.indexGen_ = second.ring_.generation(); second.stale_ = false;
+        } else {
+            first.markStale(); second.markStale();
+        }
+        index_.clear();
+        stale_ = false;
+        stats_.clear();
+        touch();
+        first.retally(); second.retally();
+    }
+
+    // Split into parts.size() rings of consecutive robots in ring order; the
+    // first robotCount() % k parts get one extra. This ring becomes empty.
+    // Parked robots rejoin the rotation first; each part keeps its own
+    // schedule mode and rebuilds its index on first lookup.
+    void splitIntoK(const std::vector<RobotRing*>& parts) {
+        unparkAll();
+        std::vector<Engine*> engines;
+        engines.reserve(parts.size());
+        for (RobotRing* p : parts) { p->clear(); engines.push_back(&p->ring_); }
+        ring_.splitIntoK(engines);
+        for (RobotRing* p : parts) { p->markStale(); p->retally(); }
+        index_.clear();
+        stale_ = false;
+        stats_.clear();
+        touch();
+    }
+
+    // Splice other after our tail; 'other' becomes empty. O(other.size())
+    // for the index. Other's parked robots join ours. Refused (false, both
+    // rings left as they were) if a robot id is in both rings, rotation or
+    // parked, since the index and the parked table hold one robot per id.
+    bool mergeWith(RobotRing& other) {
+        if (!other.robotCount()) return true;
+        sync(); other.sync();
+        auto ours = [&](int id) { return index_.count(id) || parked_.count(id); };
+        for (const auto& e : other.index_) if (ours(e.first)) return false;
+        for (const auto& e : other.parked_) if (ours(e.first)) return false;
+        touch(); other.touch();
+        stats_.merge(other.stats_);
+        parked_.merge(other.parked_);           // no shared ids: every entry moves
+        if (other.empty()) return true;
+        const std::size_t gen = ring_.generation();
+        ring_.mergeWith(other.ring_);
+        if (Engine::stable_handles && gen == ring_.generation()) {
+            for (const auto& e : other.index_) index_.insert(e);
+            indexGen_ = ring_.generation();
+        } else {
+            markStale();
+        }
+        other.index_.clear();
+        other.stale_ = false;
+        return true;
+    }
+};
@@ -0,0 +1,220 @@
+// Scheduler.h
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+#include "Robot.h"
+#include "Simulation.h"
+
+// Scheduling policies: which robot gets the next tick. Each policy has
+//     int step(Ring& ring, OnTurn&& onTurn)
+// with stepTurn's contract (onTurn(result, robot, batteryBefore) before a
+// removed robot goes; returns +1 per tick, +3 more on a removal, 0 if no
+// robot could run). Ring is a RobotRing: the id-based policies drain and
+// erase robots through its index, out of rotation order.
+//
+// Only RoundRobin skips paused robots by spending a tick on them (the
+// original rules); the others never pick a paused robot. Policies that keep
+// their own order rebuild it (O(n log n)) whenever the ring's revision()
+// moved for a reason other than their own ticks: adds, imports, pause
+// toggles, split/merge.
+
+// The original rotation: front robot, then rotate. O(1); runTurns keeps its
+// fast-forward paths for it.
+struct RoundRobin {
+    static constexpr const char* name = "round-robin";
+
+    template <typename Ring, typename OnTurn>
+    int step(Ring& ring, OnTurn&& onTurn) { return stepTurn(ring, std::forward<OnTurn>(onTurn)); }
+};
+
+namespace detail {
+// Min-heap of (key, id) over the active robots of one ring, rebuilt when the
+// ring changes behind the policy's back. O(log n) per tick.
+template <typename Key>
+class RobotHeap {
+private:
+    using Entry = std::pair<Key, int>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap_;
+    const void* ring_ = nullptr;    // ring the heap was built for
+    std::size_t rev_ = 0;           // its revision after our last change
+
+public:
+    template <typename Ring, typename KeyOf>
+    void sync(const Ring& ring, KeyOf&& keyOf) {
+        if (ring_ == &ring && rev_ == ring.revision()) return;
+        std::vector<Entry> all;
+        all.reserve(ring.size());
+        ring.forEach([&](const Robot& r) { if (!r.paused) all.emplace_back(keyOf(r), r.id); });
+        heap_ = decltype(heap_)(std::greater<Entry>(), std::move(all));
+        ring_ = &ring;
+        rev_ = ring.revision();
+    }
+
+    // Give the top robot one tick; keyAfter(key, robot) is its new key if
+    // it stays
+    template <typename Ring, typename OnTurn, typename KeyAfter>
+    int tick(Ring& ring, OnTurn&& onTurn, KeyAfter&& keyAfter) {
+        if (heap_.empty()) return 0;
+        const Key key = heap_.top().first;
+        const int id = heap_.top().second;
+        heap_.pop();
+        const int before = ring.find(id)->battery;
+        const Robot& cur = *ring.drain(id);
+        int gained = 1;
+        if (cur.battery <= 0) {
+            onTurn(TurnResult::Removed, cur, before);
+            ring.erase(id);
+            gained += 3;
+        } else {
+            onTurn(TurnResult::Drained, cur, before);
+            heap_.emplace(keyAfter(key, cur), id);
+        }
+        rev_ = ring.revision();
+        return gained;
+    }
+};
+} // namespace detail
+
+// Always the robot with the least battery left (lowest id on a tie): drains
+// the weakest robots out of the ring first.
+class LowestBatteryFirst {
+private:
+    detail::RobotHeap<int> heap_;
+
+public:
+    static constexpr const char* name = "lowest-battery-first";
+
+    template <typename Ring, typename OnTurn>
+    int step(Ring& ring, OnTurn&& onTurn) {
+        heap_.sync(ring, [](const Robot& r) { return r.battery; });
+        return heap_.tick(ring, onTurn, [](int, const Robot& r) { return r.battery; });
+    }
+};
+
+// Stride scheduling with weight = battery: over any stretch a robot's share
+// of ticks is proportional to its battery, so full robots carry more of the
+// load and levels even out. Each robot has a pass value; the lowest pass
+// runs and then advances by 1/battery. A rebuild restarts every pass from
+// the current virtual time.
+class BatteryWeighted {
+private:
+    detail::RobotHeap<double> heap_;
+    double vtime_ = 0;              // pass of the last robot run
+
+    static double stride(const Robot& r) { return 1.0 / (r.battery > 1 ? r.battery : 1); }
+
+public:
+    static constexpr const char* name = "battery-weighted";
+
+    template <typename Ring, typename OnTurn>
+    int step(Ring& ring, OnTurn&& onTurn) {
+        heap_.sync(ring, [&](const Robot& r) { return vtime_ + stride(r); });
+        return heap_.tick(ring, onTurn, [&](double pass, const Robot& r) {
+            vtime_ = pass;
+            return pass + stride(r);
+        });
+    }
+};
+
+// Deficit round-robin in ring order. A robot reaching the head is credited
+// quantum; it keeps the head while its deficit covers its drain, paying the
+// drain per tick, and carries what is left over to its next round. Robots
+// with a small drain get more consecutive ticks, so the ring shares out
+// battery drained evenly rather than ticks. With quantum equal to every
+// robot's drain this is exactly RoundRobin. O(1) per tick once quantum is at
+// least the largest drain (otherwise a robot can need several rounds of
+// credit first). A paused robot still spends a tick and loses its deficit;
+// in ScheduleMode::Parked it is parked as it reaches the head instead, at
+// no tick, as in stepTurn.
+class DeficitRoundRobin {
+private:
+    long long quantum_;
+    std::unordered_map<int, long long> deficit_;    // robots with credit left over
+    int current_ = -1;                  // head robot already credited this round
+
+    static long long cost(const Robot& r) { return r.drain > 1 ? r.drain : 1; }
+
+public:
+    static constexpr const char* name = "deficit-round-robin";
+
+    explicit DeficitRoundRobin(long long quantum = 1) : quantum_(quantum > 0 ? quantum : 1) {}
+    long long quantum() const { return quantum_; }
+
+    template <typename Ring, typename OnTurn>
+    int step(Ring& ring, OnTurn&& onTurn) {
+        for (;;) {
+            detail::settleFront(ring, 0);   // also after each rotate below
+            if (ring.empty()) return 0;
+            const Robot& cur = ring.front();
+            if (cur.paused) {
+                deficit_.erase(cur.id);
+                current_ = -1;
+                onTurn(TurnResult::Skipped, cur, cur.battery);
+                ring.rotate();
+                return 1;
+            }
+            if (cur.id != current_) {
+                current_ = cur.id;
+                deficit_[cur.id] += quantum_;
+            }
+            if (deficit_[cur.id] >= cost(cur)) break;
+            current_ = -1;                  // not enough credit yet: next robot
+            ring.rotate();
+        }
+        const Robot& cur = ring.front();
+        long long& d = deficit_[cur.id];
+        d -= cost(cur);
+        const int before = cur.battery;
+        detail::drainFront(ring, 0);
+        if (cur.battery <= 0) {
+            onTurn(TurnResult::Removed, cur, before);
+            deficit_.erase(cur.id);
+            current_ = -1;
+            ring.pop_front();
+            return 1 + 3;
+        }
+        onTurn(TurnResult::Drained, cur, before);
+        if (d < cost(cur)) {                // round over for this robot
+            if (d == 0) deficit_.erase(cur.id);
+            current_ = -1;
+            ring.rotate();
+        }
+        return 1;
+    }
+};
+
+using SchedulePolicy = std::variant<RoundRobin, LowestBatteryFirst, BatteryWeighted, DeficitRoundRobin>;
+
+inline const char* policyName(const SchedulePolicy& p) {
+    return std::visit([](const auto& s) { return s.name; }, p);
+}
+
+// runTurns under any policy. RoundRobin goes through runTurns itself (and
+// so keeps FastForward); the others step tick by tick and ignore mode.
+template <typename Ring, typename Sink>
+TurnStats runScheduled(Ring& ring, long long n, Sink& sink, SchedulePolicy& policy,
+                       TurnMode mode = TurnMode::Step) {
+    if (std::holds_alternative<RoundRobin>(policy)) return runTurns(ring, n, sink, mode);
+    TurnStats st;
+    const bool ticks = sink.wantsTicks();
+    const bool removals = ticks || sink.wantsRemovals();
+    auto count = [&](TurnResult what, const Robot& r, int before) {
+        if (what == TurnResult::Skipped) ++st.skipped;
+        else if (what == TurnResult::Removed) ++st.removed;
+        if (ticks || (removals && what == TurnResult::Removed)) sink.record(what, r, before);
+    };
+    std::visit([&](auto& p) {
+        while (st.ticks < n) {
+            int s = p.step(ring, count);
+            if (!s) break;
+            st.score += s;
+            ++st.ticks;
+        }
+    }, policy);
+    return st;
+}
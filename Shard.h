@@ -0,0 +1,510 @@
+// Shard.h
+#pragma once
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Robot.h"
+#include "Simulation.h"
+#include "Snapshot.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#define SHARD_HAVE_PROCESSES 1
+#endif
+
+// A ring sharded across processes. The ring is cut into k runs of
+// consecutive robots with splitIntoK; shard i owns run i, so the global
+// ring order is S0 S1 ... Sk-1 (wrapping round).
+//
+// Round-robin order is kept by a token passed from shard to shard. The
+// holder runs one pass over its sub-ring (size() ticks: every tick either
+// rotates or pops the head, so each robot gets exactly one turn) and hands
+// the token on. A run that ends part way through a pass leaves the holder
+// owing the rest of it, and the next run starts there. So any sequence of
+// runs gives the same robots, batteries, order and totals as running the
+// unsplit ring; the shards run one at a time, the point is to spread the
+// fleet's memory, not to run it faster.
+//
+// Robots migrate between neighbouring shards as spliced segments encoded in
+// the snapshot format, one frame per segment: the tail of Si to the front
+// of Si+1, or the front of Si to the tail of Si-1. Neither changes the
+// global order as long as no segment crosses the token holder's head,
+// which rebalance() ensures.
+//
+// Wire protocol: a ShardFrame header and `bytes` of payload, native byte
+// order like the snapshot files. Links are connected stream sockets, so the
+// protocol runs as well over TCP between machines; ShardCluster itself
+// forks the shards on this machine and joins them with socketpairs.
+struct ShardFrame {
+    std::uint32_t kind;             // shard::Msg
+    std::uint32_t arg;
+    std::uint64_t bytes;            // payload length
+};
+
+// This run's state, carried by the token
+struct ShardToken {
+    std::int64_t budget;            // ticks left to run
+    std::int64_t ticks;
+    std::int64_t score;
+    std::int64_t removed;
+    std::int64_t skipped;
+    std::uint32_t idle;             // shards in a row with nothing to run
+    std::uint32_t holder;           // shard to start the next run (Done only)
+    std::int64_t hops;              // times the token changed shard
+};
+
+static_assert(sizeof(ShardFrame) == 16, "shard frame layout changed");
+static_assert(sizeof(ShardToken) == 56, "shard token layout changed");
+
+namespace shard {
+enum Msg : std::uint32_t {
+    Load = 1,       // ctl -> shard: snapshot payload replaces the sub-ring
+    Token,          // ctl or prev -> shard: run a pass (ShardToken payload)
+    Done,           // shard -> ctl: run finished (ShardToken payload)
+    Size,           // ctl -> shard, and the reply: {size, owed} as uint64
+    Give,           // ctl -> shard: send a segment (arg = Direction, payload uint64 count)
+    Segment,        // shard -> neighbour or ctl: snapshot payload
+    Ack,            // shard -> ctl: segment installed
+    Collect,        // ctl -> shard: reply with a Segment of the whole sub-ring
+    Stop,           // ctl -> shard: exit
+};
+
+enum Direction : std::uint32_t {
+    FrontToPrev,    // front of Si to the tail of Si-1
+    BackToNext,     // tail of Si to the front of Si+1
+    OwedToPrev,     // the part of Si's pass already run, to the tail of Si-1
+};
+
+// Robots in flight, in ring order; encodeSnapshot reads them like a ring
+struct Batch {
+    std::vector<Robot> robots;
+    std::size_t size() const { return robots.size(); }
+    template <typename F>
+    void forEach(F&& f) const { for (const Robot& r : robots) f(r); }
+};
+
+template <typename Ring>
+Batch takeFront(Ring& ring, std::size_t count) {
+    Batch s;
+    s.robots.reserve(count);
+    for (std::size_t i = 0; i < count && !ring.empty(); ++i) {
+        s.robots.push_back(ring.front());
+        ring.pop_front();
+    }
+    return s;
+}
+
+// The last count robots: rotate the rest past them, then take them off the
+// front, which leaves the rest in their old order
+template <typename Ring>
+Batch takeBack(Ring& ring, std::size_t count) {
+    count = std::min(count, ring.size());
+    for (std::size_t i = count; i < ring.size(); ++i) ring.rotate();
+    return takeFront(ring, count);
+}
+
+// Decoded segment spliced onto either end with mergeWith; false if it does
+// not decode or shares a robot id with the ring
+template <typename Ring>
+bool putSegment(Ring& ring, std::string_view bytes, bool atFront) {
+    Ring seg(ring.get_allocator());
+    SnapshotCounters c;
+    if (!decodeSnapshot(bytes, seg, c).ok) return false;
+    if (!atFront) return ring.mergeWith(seg);
+    if (!seg.mergeWith(ring)) return false;  // seg + ring, then back into ring
+    return ring.mergeWith(seg);
+}
+
+#ifdef SHARD_HAVE_PROCESSES
+#ifdef MSG_NOSIGNAL
+constexpr int kSendFlags = MSG_NOSIGNAL;    // a dead peer is an error, not SIGPIPE
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+inline bool writeAll(int fd, const void* p, std::size_t n) {
+    const char* c = static_cast<const char*>(p);
+    while (n > 0) {
+        ssize_t w = ::send(fd, c, n, kSendFlags);
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) return false;
+        c += w;
+        n -= static_cast<std::size_t>(w);
+    }
+    return true;
+}
+
+inline bool readAll(int fd, void* p, std::size_t n) {
+    char* c = static_cast<char*>(p);
+    while (n > 0) {
+        ssize_t r = ::read(fd, c, n);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return false;
+        c += r;
+        n -= static_cast<std::size_t>(r);
+    }
+    return true;
+}
+
+inline bool send(int fd, std::uint32_t kind, std::uint32_t arg, std::string_view payload = {}) {
+    ShardFrame f{kind, arg, payload.size()};
+    return writeAll(fd, &f, sizeof f) && writeAll(fd, payload.data(), payload.size());
+}
+
+template <typename T>
+bool sendValue(int fd, std::uint32_t kind, std::uint32_t arg, const T& v) {
+    return send(fd, kind, arg, std::string_view(reinterpret_cast<const char*>(&v), sizeof v));
+}
+
+inline bool recv(int fd, ShardFrame& f, std::string& payload) {
+    if (!readAll(fd, &f, sizeof f)) return false;
+    payload.resize(static_cast<std::size_t>(f.bytes));
+    return readAll(fd, &payload[0], payload.size());
+}
+
+template <typename T>
+bool payloadAs(const std::string& payload, T& v) {
+    if (payload.size() != sizeof v) return false;
+    std::memcpy(&v, payload.data(), sizeof v);
+    return true;
+}
+
+// One shard process: serves ctl and its two ring links until Stop or a
+// broken link. Returns the process exit status.
+template <typename Ring>
+int shardMain(std::uint32_t self, std::uint32_t shards, int ctl, int prev, int next, TurnMode mode) {
+    Ring ring;
+    std::size_t owed = 0;           // ticks left in an interrupted pass
+    ShardFrame f;
+    std::string payload;
+
+    auto onToken = [&](ShardToken t) {
+        if (t.budget > 0 && t.idle < shards) {
+            const long long pass = static_cast<long long>(owed ? owed : ring.size());
+            const long long k = std::min<long long>(pass, t.budget);
+            TurnStats st = runTurns(ring, k, nullptr, mode);
+            t.budget -= st.ticks;
+            t.ticks += st.ticks; t.score += st.score;
+            t.removed += st.removed; t.skipped += st.skipped;
+            owed = st.ticks < pass && !ring.empty() ? static_cast<std::size_t>(pass - st.ticks) : 0;
+            t.idle = st.ticks == 0 ? t.idle + 1 : 0;
+        }
+        if (t.budget > 0 && t.idle < shards) {
+            ++t.hops;
+            return sendValue(next, Token, 0, t);
+        }
+        t.holder = owed ? self : (self + 1) % shards;
+        return sendValue(ctl, Done, 0, t);
+    };
+
+    auto onCtl = [&]() {
+        switch (f.kind) {
+        case Load: {
+            SnapshotCounters c;
+            owed = 0;
+            return decodeSnapshot(payload, ring, c).ok && send(ctl, Ack, 0);
+        }
+        case Token: { ShardToken t; return payloadAs(payload, t) && onToken(t); }
+        case Size: {
+            const std::uint64_t v[2] = {ring.size(), owed};
+            return send(ctl, Size, 0, std::string_view(reinterpret_cast<const char*>(v), sizeof v));
+        }
+        case Give: {
+            std::uint64_t count = 0;
+            if (!payloadAs(payload, count)) return false;
+            Batch s;
+            if (f.arg == FrontToPrev) s = takeFront(ring, count);
+            else if (f.arg == BackToNext) s = takeBack(ring, count);
+            else { s = takeBack(ring, ring.size() - owed); owed = 0; }
+            return send(f.arg == BackToNext ? next : prev, Segment, 0, encodeSnapshot(s, SnapshotCounters()));
+        }
+        case Collect: return send(ctl, Segment, 0, encodeSnapshot(ring, SnapshotCounters()));
+        default: return false;
+        }
+    };
+
+    pollfd fds[3] = {{ctl, POLLIN, 0}, {prev, POLLIN, 0}, {next, POLLIN, 0}};
+    for (;;) {
+        if (::poll(fds, 3, -1) < 0) {
+            if (errno == EINTR) continue;
+            return 1;
+        }
+        for (int i = 0; i < 3; ++i) {
+            if (!fds[i].revents) continue;
+            if (!recv(fds[i].fd, f, payload)) return 1;
+            bool ok;
+            if (i == 0) {
+                if (f.kind == Stop) return 0;
+                ok = onCtl();
+            } else if (f.kind == Token) {
+                ShardToken t;
+                ok = payloadAs(payload, t) && onToken(t);
+            } else if (f.kind == Segment) {
+                // from prev: its tail, which goes in front; from next: its front, at the tail
+                ok = putSegment(ring, payload, i == 1) && send(ctl, Ack, 0);
+            } else {
+                ok = false;
+            }
+            if (!ok) return 1;
+        }
+    }
+}
+#endif
+} // namespace shard
+
+// Totals for a ShardCluster's lifetime
+struct ShardStats {
+    long long hops = 0;             // token hand-offs between shards
+    long long migrated = 0;         // robots moved by rebalance()
+    long long rebalances = 0;       // rebalance() calls that moved robots
+};
+
+// Coordinator for k shard processes. start() moves a ring's robots into the
+// shards, run() advances the global round-robin, rebalance() evens out the
+// shard sizes, gather() brings the robots back in global order. Failures
+// come back as false with error() set; the shards are then stopped.
+template <typename Ring>
+class ShardCluster {
+private:
+    struct Shard {
+        int ctl = -1;
+#ifdef SHARD_HAVE_PROCESSES
+        pid_t pid = -1;
+#endif
+    };
+    std::vector<Shard> shards_;
+    std::uint32_t holder_ = 0;      // shard whose head is the global head
+    ShardStats stats_;
+    std::string error_;
+
+    bool fail(const std::string& why) {
+        if (error_.empty()) error_ = why;
+        stop();
+        return false;
+    }
+
+#ifdef SHARD_HAVE_PROCESSES
+    bool expect(std::size_t i, std::uint32_t kind, std::string& payload) {
+        ShardFrame f;
+        return shard::recv(shards_[i].ctl, f, payload) && f.kind == kind;
+    }
+
+    // {size, owed} of shard i
+    bool size(std::size_t i, std::uint64_t (&v)[2]) {
+        std::string payload;
+        if (!shard::send(shards_[i].ctl, shard::Size, 0) || !expect(i, shard::Size, payload)
+            || payload.size() != sizeof v) return false;
+        std::memcpy(v, payload.data(), sizeof v);
+        return true;
+    }
+
+    // Shard i gives count robots; the receiving neighbour acks on its ctl
+    bool give(std::size_t i, shard::Direction d, std::uint64_t count) {
+        const std::size_t to = d == shard::BackToNext ? (i + 1) % shards_.size()
+                                                      : (i + shards_.size() - 1) % shards_.size();
+        std::string payload;
+        return shard::sendValue(shards_[i].ctl, shard::Give, d, count) && expect(to, shard::Ack, payload);
+    }
+
+    // Hand the holder's finished part of an interrupted pass to the shard
+    // before it, so every shard starts on a pass boundary and the global
+    // order is S_holder, S_holder+1, ... with no split shard in it
+    bool settle() {
+        std::uint64_t v[2];
+        if (!size(holder_, v)) return false;
+        if (v[1] == 0) return true;
+        return give(holder_, shard::OwedToPrev, v[0] - v[1]);
+    }
+#endif
+
+public:
+    ShardCluster() = default;
+    ~ShardCluster() { stop(); }
+    ShardCluster(const ShardCluster&) = delete;
+    ShardCluster& operator=(const ShardCluster&) = delete;
+
+    std::size_t shards() const { return shards_.size(); }
+    const ShardStats& stats() const { return stats_; }
+    const std::string& error() const { return error_; }
+
+    // Fork k shard processes and move ring's robots into them (ring becomes
+    // empty). Rings that park robots must be in Inline mode.
+    bool start(Ring& ring, std::size_t k, TurnMode mode = TurnMode::FastForward) {
+#ifdef SHARD_HAVE_PROCESSES
+        if (!shards_.empty()) return fail("cluster already started");
+        if (k == 0) k = 1;
+        std::vector<int> ctl(2 * k), link(2 * k);   // link i joins shard i and i+1
+        for (std::size_t i = 0; i < k; ++i)
+            if (::socketpair(AF_UNIX, SOCK_STREAM, 0, &ctl[2 * i]) != 0
+                || ::socketpair(AF_UNIX, SOCK_STREAM, 0, &link[2 * i]) != 0)
+                return fail("socketpair failed");
+        std::cout.flush();
+        std::cerr.flush();
+        shards_.resize(k);
+        for (std::size_t i = 0; i < k; ++i) {
+            pid_t pid = ::fork();
+            if (pid < 0) return fail("fork failed");
+            if (pid == 0) {
+                const int prev = link[2 * ((i + k - 1) % k) + 1], next = link[2 * i];
+                for (std::size_t j = 0; j < 2 * k; ++j) {
+                    if (j != 2 * i + 1) ::close(ctl[j]);
+                    if (link[j] != prev && link[j] != next) ::close(link[j]);
+                }
+                ::_exit(shard::shardMain<Ring>(static_cast<std::uint32_t>(i), static_cast<std::uint32_t>(k),
+                                              ctl[2 * i + 1], prev, next, mode));
+            }
+            shards_[i].pid = pid;
+            shards_[i].ctl = ctl[2 * i];
+        }
+        for (std::size_t j = 0; j < 2 * k; ++j) {
+            ::close(link[j]);
+            if (j % 2) ::close(ctl[j]);
+        }
+
+        std::vector<std::unique_ptr<Ring>> parts;
+        std::vector<Ring*> raw;
+        for (std::size_t i = 0; i < k; ++i) {
+            parts.push_back(std::make_unique<Ring>());
+            raw.push_back(parts.back().get());
+        }
+        ring.splitIntoK(raw);
+        std::string payload;
+        for (std::size_t i = 0; i < k; ++i) {
+            if (!shard::send(shards_[i].ctl, shard::Load, 0, encodeSnapshot(*parts[i], SnapshotCounters()))
+                || !expect(i, shard::Ack, payload))
+                return fail("shard " + std::to_string(i) + " did not load");
+            parts[i]->clear();
+        }
+        holder_ = 0;
+        return true;
+#else
+        (void)ring; (void)k; (void)mode;
+        return fail("shards need a POSIX system");
+#endif
+    }
+
+    // Advance the global round-robin by up to n ticks (fewer only if every
+    // shard runs out of robots)
+    TurnStats run(long long n) {
+        TurnStats st;
+#ifdef SHARD_HAVE_PROCESSES
+        if (shards_.empty() || n <= 0) return st;
+        ShardToken t{};
+        t.budget = n;
+        if (!shard::sendValue(shards_[holder_].ctl, shard::Token, 0, t)) { fail("token lost"); return st; }
+        // the Done comes from whichever shard the run ends on
+        std::vector<pollfd> fds;
+        for (const Shard& s : shards_) fds.push_back({s.ctl, POLLIN, 0});
+        while (::poll(fds.data(), fds.size(), -1) < 0)
+            if (errno != EINTR) { fail("poll failed"); return st; }
+        std::size_t i = 0;
+        while (!fds[i].revents) ++i;
+        std::string payload;
+        if (!expect(i, shard::Done, payload) || !shard::payloadAs(payload, t)) { fail("token lost"); return st; }
+        holder_ = t.holder;
+        stats_.hops += t.hops;
+        st.ticks = t.ticks; st.score = t.score; st.removed = t.removed; st.skipped = t.skipped;
+#else
+        (void)n;
+#endif
+        return st;
+    }
+
+    // Even out the shard sizes by moving segments across the boundaries of
+    // the global order (never across the holder's head). Boundaries whose
+    // imbalance is under 1/slack of the per-shard target are left alone.
+    bool rebalance(std::size_t slack = 8) {
+#ifdef SHARD_HAVE_PROCESSES
+        const std::size_t k = shards_.size();
+        if (k < 2) return true;
+        if (!settle()) return fail("settle failed");
+        std::vector<long long> have(k);
+        long long total = 0;
+        for (std::size_t j = 0; j < k; ++j) {          // j-th shard from the holder
+            std::uint64_t v[2];
+            if (!size((holder_ + j) % k, v)) return fail("size query failed");
+            have[j] = static_cast<long long>(v[0]);
+            total += have[j];
+        }
+        const long long tolerance = std::max(1LL, total / static_cast<long long>(k) / static_cast<long long>(slack));
+        // flow[j] > 0 moves robots from chain position j to j+1, < 0 back;
+        // prefix sums against the target decide each boundary
+        std::vector<long long> flow(k - 1);
+        long long prefix = 0, want = 0;
+        bool any = false;
+        for (std::size_t j = 0; j + 1 < k; ++j) {
+            prefix += have[j];
+            want += total / static_cast<long long>(k) + (static_cast<long long>(j) < total % static_cast<long long>(k) ? 1 : 0);
+            flow[j] = prefix - want;
+            if (flow[j] >= tolerance || -flow[j] >= tolerance) any = true;
+        }
+        if (!any) return true;
+        // a shard may have to receive before it can give, so repeat passes
+        // moving what each side holds until every flow is done
+        long long moved = 0;
+        for (bool progress = true; progress;) {
+            progress = false;
+            for (std::size_t j = 0; j + 1 < k; ++j) {
+                const std::size_t from = flow[j] > 0 ? j : j + 1;
+                const long long n = std::min(flow[j] > 0 ? flow[j] : -flow[j], have[from]);
+                if (n == 0) continue;
+                const std::size_t id = (holder_ + from) % k;
+                if (!give(id, flow[j] > 0 ? shard::BackToNext : shard::FrontToPrev, static_cast<std::uint64_t>(n)))
+                    return fail("migration failed");
+                have[from] -= n;
+                have[flow[j] > 0 ? j + 1 : j] += n;
+                flow[j] += flow[j] > 0 ? -n : n;
+                moved += n;
+                progress = true;
+            }
+        }
+        stats_.migrated += moved;
+        ++stats_.rebalances;
+        return true;
+#else
+        (void)slack;
+        return false;
+#endif
+    }
+
+    // Bring every robot back into ring (cleared first) in global order, head
+    // first, and stop the shards
+    bool gather(Ring& ring) {
+        ring.clear();
+#ifdef SHARD_HAVE_PROCESSES
+        if (shards_.empty()) return true;
+        if (!settle()) return fail("settle failed");
+        std::string payload;
+        for (std::size_t j = 0; j < shards_.size(); ++j) {
+            const std::size_t i = (holder_ + j) % shards_.size();
+            if (!shard::send(shards_[i].ctl, shard::Collect, 0) || !expect(i, shard::Segment, payload)
+                || !shard::putSegment(ring, payload, false))
+                return fail("shard " + std::to_string(i) + " did not return its robots");
+        }
+        stop();
+#endif
+        return true;
+    }
+
+    // Stop the shard processes (their robots are dropped)
+    void stop() {
+#ifdef SHARD_HAVE_PROCESSES
+        for (Shard& s : shards_) {
+            shard::send(s.ctl, shard::Stop, 0);
+            ::close(s.ctl);
+        }
+        for (Shard& s : shards_) ::waitpid(s.pid, nullptr, 0);
+#endif
+        shards_.clear();
+    }
+};
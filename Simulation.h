@@ -0,0 +1,274 @@
+// Simulation.h
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+#include "FleetSoA.h"
+#include "Robot.h"
+
+// What happened to the head robot on one tick
+enum class TurnResult { Skipped, Drained, Removed };
+
+// Totals accumulated by runTurns
+struct TurnStats {
+    long long ticks = 0;
+    long long score = 0;
+    long long removed = 0;
+    long long skipped = 0;
+
+    TurnStats& operator+=(const TurnStats& o) {
+        ticks += o.ticks; score += o.score; removed += o.removed; skipped += o.skipped;
+        return *this;
+    }
+};
+
+// Console/log line for one tick (same text runOneTurn has always printed)
+inline void formatTurn(std::ostream& os, TurnResult what, const Robot& r, int before) {
+    if (what == TurnResult::Skipped) {
+        os << "Skipped (paused): " << r << "\n";
+        return;
+    }
+    os << "Tick: " << robotName(r) << " battery " << before << " -> " << r.battery << "\n";
+    if (what == TurnResult::Removed)
+        os << "Removed: " << r << " (returned to dock)\n";
+}
+
+namespace detail {
+// Rings that park paused robots (RobotRing) clear them off the head before
+// each tick; plain engines have nothing to do.
+template <typename Ring>
+auto settleFront(Ring& ring, int) -> decltype(ring.settleFront(), void()) { ring.settleFront(); }
+template <typename Ring>
+void settleFront(Ring&, long) {}
+
+// Rings that keep running stats (RobotRing) apply the drain themselves
+template <typename Ring>
+auto drainFront(Ring& ring, int) -> decltype(ring.drainFront(), void()) { ring.drainFront(); }
+template <typename Ring>
+void drainFront(Ring& ring, long) { Robot& r = ring.front(); r.battery -= r.drain; }
+
+// fastForward's jump: full drains for every robot, one more for the first
+// part of them in ring order
+template <typename Ring>
+auto drainAll(Ring& ring, long long full, long long part, int) -> decltype(ring.drainAll(full, part), void()) {
+    ring.drainAll(full, part);
+}
+template <typename Ring>
+void drainAll(Ring& ring, long long full, long long part, long) {
+    long long i = 0;
+    ring.forEach([&](Robot& r) {
+        long long turns = full + (i++ < part ? 1 : 0);
+        r.battery = static_cast<int>(r.battery - turns * r.drain);
+    });
+}
+
+// True for a ring in ScheduleMode::Parked, whose paused robots leave the
+// rotation when they reach the head instead of costing a tick per lap
+template <typename Ring>
+auto parks(const Ring& ring, int) -> decltype(ring.parking()) { return ring.parking(); }
+template <typename Ring>
+bool parks(const Ring&, long) { return false; }
+}
+
+// One tick of round-robin, without any I/O.
+// onTurn(result, robot, batteryBefore) runs before a removed robot is popped.
+// Returns the score for the tick: +1, plus 3 if the robot was removed, or 0
+// if there was no robot to run (empty ring, or every robot parked).
+template <typename Ring, typename OnTurn>
+int stepTurn(Ring& ring, OnTurn&& onTurn) {
+    detail::settleFront(ring, 0);
+    if (ring.empty()) return 0;
+    const Robot& cur = ring.front();       // head robot
+    if (cur.paused) {                      // paused → skip and rotate
+        onTurn(TurnResult::Skipped, cur, cur.battery);
+        ring.rotate();
+        return 1;                          // still a processed tick
+    }
+
+    int before = cur.battery;
+    detail::drainFront(ring, 0);           // battery -= drain
+    if (cur.battery <= 0) {                // removal occurs at head
+        onTurn(TurnResult::Removed, cur, before);
+        ring.pop_front();                  // do NOT rotate after removal
+        return 1 + 3;                      // +1 tick, +3 removal bonus
+    }
+    onTurn(TurnResult::Drained, cur, before);
+    ring.rotate();                         // alive → move to next
+    return 1;
+}
+
+// Turn at which a robot's drain first takes it to <= 0 (1 = its next turn),
+// or "never" for a non-positive drain that keeps it alive.
+inline long long turnsUntilEmpty(const Robot& r) {
+    const long long never = std::numeric_limits<long long>::max();
+    if (static_cast<long long>(r.battery) - r.drain <= 0) return 1;
+    if (r.drain <= 0) return never;
+    return (static_cast<long long>(r.battery) + r.drain - 1) / r.drain;
+}
+
+// Jump ahead up to n ticks in closed form while no robot is paused.
+// With nothing paused every lap drains each robot once, so the next removal
+// is the robot with the fewest turns left (first in ring order on a tie).
+// Each jump costs O(ring size) and lands either on that removal or on tick n,
+// leaving battery, head position, score and ticks exactly as n calls to
+// stepTurn would. A lap that already has a removal due is stepped instead.
+// Stops early (st.ticks < n) if it finds a paused robot.
+// onRemove(robot, batteryBefore) runs for each removal before its pop_front.
+template <typename Ring, typename OnRemove>
+TurnStats fastForward(Ring& ring, long long n, OnRemove&& onRemove) {
+    const long long never = std::numeric_limits<long long>::max();
+    TurnStats st;
+    while (st.ticks < n && !ring.empty()) {
+        const long long m = static_cast<long long>(ring.size());
+        long long k = never;               // lap of the next removal
+        long long pos = 0;                 // its position in ring order
+        long long i = 0;
+        bool paused = false;
+        std::as_const(ring).forEach([&](const Robot& r) {
+            if (r.paused) paused = true;
+            long long t = turnsUntilEmpty(r);
+            if (t < k) { k = t; pos = i; }
+            ++i;
+        });
+        if (paused) break;
+
+        const long long left = n - st.ticks;
+        if (k == 1) {
+            // a removal is due this lap: stepping the lap costs no more than
+            // the jump and takes every removal in it, where jumping would
+            // rescan the ring once per removal
+            const long long lap = std::min(left, m);
+            for (long long j = 0; j < lap && !ring.empty(); ++j) {
+                st.score += stepTurn(ring, [&](TurnResult what, const Robot& r, int before) {
+                    if (what == TurnResult::Removed) { onRemove(r, before); ++st.removed; }
+                });
+                ++st.ticks;
+            }
+            continue;
+        }
+        bool removal = k != never && left > pos && (k - 1) <= (left - pos - 1) / m;
+        long long full, part;              // whole laps, then extra turns
+        if (removal) { full = k - 1; part = pos + 1; }
+        else         { full = left / m;  part = left % m; }
+
+        detail::drainAll(ring, full, part, 0);
+        const long long done = full * m + part;
+        if (removal) {
+            for (long long j = 0; j < pos; ++j) ring.rotate();
+            const Robot& gone = ring.front();
+            onRemove(gone, gone.battery + gone.drain);
+            ring.pop_front();              // removed robot was at head
+            ++st.removed;
+            st.score += 3;
+        } else {
+            for (long long j = 0; j < part; ++j) ring.rotate();
+        }
+        st.ticks += done;
+        st.score += done;
+    }
+    return st;
+}
+
+template <typename Ring>
+TurnStats fastForward(Ring& ring, long long n) {
+    return fastForward(ring, n, [](const Robot&, int) {});
+}
+
+// Run whole laps (ring.size() ticks each) up to n ticks while some robot is
+// paused, which is where fastForward gives up. A lap without a removal only
+// drains every active robot once and brings the head back where it started,
+// so the ring is copied into a FleetSoA and the laps run as vector passes
+// over its battery array; the batteries are written back at the end. Stops
+// before the first lap that would remove a robot, or when less than a lap
+// is left.
+template <typename Ring>
+TurnStats lapForward(Ring& ring, long long n) {
+    TurnStats st;
+    const long long m = static_cast<long long>(ring.size());
+    if (m == 0 || n < m) return st;
+    FleetSoA soa;
+    soa.load(ring);
+    long long laps = 0;
+    while ((laps + 1) * m <= n && soa.lap()) ++laps;
+    if (laps == 0) return st;
+    soa.storeBatteries(ring);
+    st.ticks = laps * m;
+    st.score = laps * m;
+    st.skipped = laps * static_cast<long long>(soa.pausedCount);
+    return st;
+}
+
+enum class TurnMode { Step, FastForward };
+
+// Where runTurns sends tick events. A sink provides
+//   bool wantsTicks() const;      // every Skipped/Drained/Removed event
+//   bool wantsRemovals() const;   // Removed events (implied by wantsTicks)
+//   void record(TurnResult, const Robot&, int batteryBefore);
+// StreamSink writes formatTurn lines to a stream; nullptr means no events.
+struct StreamSink {
+    std::ostream* os = nullptr;
+    bool wantsTicks() const { return os != nullptr; }
+    bool wantsRemovals() const { return os != nullptr; }
+    void record(TurnResult what, const Robot& r, int before) { formatTurn(*os, what, r, before); }
+};
+
+// Advance the ring up to n ticks in one pass (stops early if no robot is left
+// to run), sending events to sink.
+// TurnMode::FastForward jumps between removals while nothing is paused,
+// runs whole laps as SoA vector passes otherwise, and steps only the laps
+// that contain a removal. It is used only when the sink does not want every
+// tick; a removals-only sink still gets each removal from the jumps.
+template <typename Ring, typename Sink,
+          typename = std::enable_if_t<!std::is_pointer<Sink>::value>>
+TurnStats runTurns(Ring& ring, long long n, Sink& sink, TurnMode mode = TurnMode::Step) {
+    TurnStats st;
+    const bool ticks = sink.wantsTicks();
+    const bool removals = ticks || sink.wantsRemovals();
+    auto count = [&](TurnResult what, const Robot& r, int before) {
+        if (what == TurnResult::Skipped) ++st.skipped;
+        else if (what == TurnResult::Removed) ++st.removed;
+        if (ticks || (removals && what == TurnResult::Removed)) sink.record(what, r, before);
+    };
+    auto removed = [&](const Robot& r, int before) {
+        if (removals) sink.record(TurnResult::Removed, r, before);
+    };
+    auto stepUntil = [&](long long limit) {
+        while (st.ticks < limit) {
+            int s = stepTurn(ring, count);
+            if (!s) break;
+            st.score += s;
+            ++st.ticks;
+        }
+    };
+    if (mode == TurnMode::FastForward && !ticks) {
+        // fastForward stops on a paused robot; then run whole laps in SoA
+        // form up to the next removal and step that lap tick by tick, and
+        // repeat. A parking ring skips the SoA laps, which would charge its
+        // paused robots a tick each: the stepped lap parks them all, and
+        // fastForward takes over from there.
+        const bool parking = detail::parks(ring, 0);
+        st += fastForward(ring, n, removed);
+        while (st.ticks < n && !ring.empty()) {
+            if (!parking) st += lapForward(ring, n - st.ticks);
+            const long long before = st.ticks;
+            stepUntil(std::min(n, st.ticks + static_cast<long long>(ring.size())));
+            if (st.ticks == before) break;
+            st += fastForward(ring, n - st.ticks, removed);
+        }
+    }
+    stepUntil(n);
+    return st;
+}
+
+// Stream form: nothing is written per tick unless a log stream is given;
+// pass e.g. an std::ostringstream to collect the tick lines and flush them
+// once at the end. FastForward is ignored when a log is requested.
+template <typename Ring>
+TurnStats runTurns(Ring& ring, long long n, std::ostream* log = nullptr,
+                   TurnMode mode = TurnMode::Step) {
+    StreamSink sink{log};
+    return runTurns(ring, n, sink, mode);
+}
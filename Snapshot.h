@@ -0,0 +1,235 @@
+// Snapshot.h
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "FleetIO.h"
+#include "Robot.h"
+
+// Flat, versioned binary snapshot of a ring plus the simulation counters:
+//
+//   SnapshotHeader                          (56 bytes)
+//   SnapshotRecord[robotCount]              (24 bytes each, ring order, head first)
+//   name bytes[nameBytes]                   (records point into this blob)
+//
+// Native byte order; the header's byteOrder field rejects files written on a
+// machine of the other endianness. Name offsets are 32-bit, so the name blob
+// is limited to kMaxNameBytes. Restore maps the file, checks the records
+// (name bounds, unique ids) and builds the ring straight from them in one
+// append_range pass.
+struct SnapshotHeader {
+    char magic[8];                  // "RRSNAP\0\0"
+    std::uint32_t version;
+    std::uint32_t byteOrder;        // kByteOrder as written
+    std::uint64_t robotCount;
+    std::uint64_t nameBytes;
+    std::int64_t score;
+    std::int64_t ticks;
+    std::int32_t nextId;
+    std::uint32_t reserved;
+};
+
+struct SnapshotRecord {
+    std::int32_t id;
+    std::int32_t battery;
+    std::int32_t drain;
+    std::uint32_t nameOffset;       // into the name blob
+    std::uint32_t nameLen;
+    std::uint8_t paused;
+    std::uint8_t pad[3];
+};
+
+static_assert(sizeof(SnapshotHeader) == 56, "snapshot header layout changed");
+static_assert(sizeof(SnapshotRecord) == 24, "snapshot record layout changed");
+
+namespace snapshot {
+constexpr char kMagic[8] = {'R', 'R', 'S', 'N', 'A', 'P', 0, 0};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::uint32_t kByteOrder = 0x01020304;
+constexpr std::uint64_t kMaxNameBytes = std::numeric_limits<std::uint32_t>::max();
+
+// Rings that park robots (RobotRing) save those too, after the rotation
+template <typename Ring, typename F>
+auto forEachParked(const Ring& ring, F&& f, int) -> decltype(ring.forEachParked(f), void()) {
+    ring.forEachParked(f);
+}
+template <typename Ring, typename F>
+void forEachParked(const Ring&, F&&, long) {}
+
+// Input iterator that turns mapped records into Robots on the fly
+class RecordIterator {
+private:
+    const char* rec_;
+    const char* names_;
+
+public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = Robot;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = Robot;
+
+    RecordIterator(const char* rec, const char* names) : rec_(rec), names_(names) {}
+
+    Robot operator*() const {
+        SnapshotRecord r;
+        std::memcpy(&r, rec_, sizeof r);
+        return Robot(r.id, Robot::NameArg(names_ + r.nameOffset, r.nameLen),
+                     r.battery, r.drain, r.paused != 0);
+    }
+    RecordIterator& operator++() { rec_ += sizeof(SnapshotRecord); return *this; }
+    bool operator==(const RecordIterator& o) const { return rec_ == o.rec_; }
+    bool operator!=(const RecordIterator& o) const { return rec_ != o.rec_; }
+};
+} // namespace snapshot
+
+struct SnapshotCounters {
+    long long score = 0;
+    long long ticks = 0;
+    int nextId = 1;
+};
+
+struct SnapshotResult {
+    bool ok = false;
+    std::string error;              // set when !ok
+    std::size_t robots = 0;
+    double seconds = 0.0;
+};
+
+// Serialize the encoded form of a ring into memory (used for files and for
+// anything else that wants the same bytes). Returns an empty string, which
+// no decoder accepts, if the names would pass kMaxNameBytes.
+template <typename Ring>
+std::string encodeSnapshot(const Ring& ring, const SnapshotCounters& c) {
+    std::vector<SnapshotRecord> recs;
+    std::string names;
+    bool overflow = false;
+    auto add = [&](const Robot& r) {
+        std::string_view name = robotName(r);
+        if (overflow || name.size() > snapshot::kMaxNameBytes - names.size()) { overflow = true; return; }
+        SnapshotRecord rec{};
+        rec.id = r.id;
+        rec.battery = r.battery;
+        rec.drain = r.drain;
+        rec.nameOffset = static_cast<std::uint32_t>(names.size());
+        rec.nameLen = static_cast<std::uint32_t>(name.size());
+        rec.paused = r.paused ? 1 : 0;
+        names += name;
+        recs.push_back(rec);
+    };
+    recs.reserve(ring.size());
+    ring.forEach(add);
+    snapshot::forEachParked(ring, add, 0);
+    if (overflow) return std::string();
+
+    SnapshotHeader h{};
+    std::memcpy(h.magic, snapshot::kMagic, sizeof h.magic);
+    h.version = snapshot::kVersion;
+    h.byteOrder = snapshot::kByteOrder;
+    h.robotCount = recs.size();
+    h.nameBytes = names.size();
+    h.score = c.score;
+    h.ticks = c.ticks;
+    h.nextId = c.nextId;
+
+    std::string out;
+    out.reserve(sizeof h + recs.size() * sizeof(SnapshotRecord) + names.size());
+    out.append(reinterpret_cast<const char*>(&h), sizeof h);
+    out.append(reinterpret_cast<const char*>(recs.data()), recs.size() * sizeof(SnapshotRecord));
+    out += names;
+    return out;
+}
+
+// Rebuild ring (cleared first) and counters from encoded bytes. The bytes
+// must outlive the call only; names are copied into the robots. Snapshots
+// with a name blob past kMaxNameBytes, a name reference out of bounds or a
+// repeated robot id (or the largest int as an id) are rejected before the
+// ring is touched. A nextId at or below a restored id is raised past the
+// largest one, so new robots never reuse an id (shard segments carry no
+// counters and store nextId 1).
+template <typename Ring>
+SnapshotResult decodeSnapshot(std::string_view bytes, Ring& ring, SnapshotCounters& c) {
+    SnapshotResult res;
+    SnapshotHeader h;
+    if (bytes.size() < sizeof h) { res.error = "truncated header"; return res; }
+    std::memcpy(&h, bytes.data(), sizeof h);
+    if (std::memcmp(h.magic, snapshot::kMagic, sizeof h.magic) != 0) { res.error = "not a snapshot"; return res; }
+    if (h.byteOrder != snapshot::kByteOrder) { res.error = "foreign byte order"; return res; }
+    if (h.version != snapshot::kVersion) { res.error = "unsupported version " + std::to_string(h.version); return res; }
+    const std::uint64_t body = bytes.size() - sizeof h;
+    if (h.robotCount > body / sizeof(SnapshotRecord)
+        || body - h.robotCount * sizeof(SnapshotRecord) < h.nameBytes) {
+        res.error = "truncated body"; return res;
+    }
+    if (h.nameBytes > snapshot::kMaxNameBytes) { res.error = "name data past 4 GiB"; return res; }
+
+    const char* recs = bytes.data() + sizeof h;
+    const char* names = recs + h.robotCount * sizeof(SnapshotRecord);
+    std::vector<std::int32_t> ids;
+    ids.reserve(static_cast<std::size_t>(h.robotCount));
+    for (std::uint64_t i = 0; i < h.robotCount; ++i) {      // bounds and ids; cheap
+        SnapshotRecord r;
+        std::memcpy(&r, recs + i * sizeof r, sizeof r);
+        if (static_cast<std::uint64_t>(r.nameOffset) + r.nameLen > h.nameBytes) {
+            res.error = "corrupt name reference"; return res;
+        }
+        ids.push_back(r.id);
+    }
+    std::sort(ids.begin(), ids.end());
+    auto dup = std::adjacent_find(ids.begin(), ids.end());
+    if (dup != ids.end()) { res.error = "duplicate robot id " + std::to_string(*dup); return res; }
+    if (!ids.empty() && ids.back() == std::numeric_limits<std::int32_t>::max()) {
+        res.error = "robot id " + std::to_string(ids.back()) + " leaves no id for new robots"; return res;
+    }
+
+    ring.clear();
+    ring.reserve(h.robotCount);
+    ring.append_range(snapshot::RecordIterator(recs, names),
+                      snapshot::RecordIterator(names, names));
+    c.score = h.score;
+    c.ticks = h.ticks;
+    c.nextId = ids.empty() || h.nextId > ids.back() ? h.nextId : ids.back() + 1;
+    res.robots = static_cast<std::size_t>(h.robotCount);
+    res.ok = true;
+    return res;
+}
+
+template <typename Ring>
+SnapshotResult saveSnapshot(const std::string& path, const Ring& ring, const SnapshotCounters& c) {
+    const auto t0 = std::chrono::steady_clock::now();
+    SnapshotResult res;
+    std::string bytes = encodeSnapshot(ring, c);
+    if (bytes.empty()) { res.error = "robot names pass 4 GiB"; return res; }
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()))) {
+        res.error = "cannot write " + path;
+        return res;
+    }
+    SnapshotHeader h;
+    std::memcpy(&h, bytes.data(), sizeof h);
+    res.ok = true;
+    res.robots = static_cast<std::size_t>(h.robotCount);
+    res.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return res;
+}
+
+template <typename Ring>
+SnapshotResult loadSnapshot(const std::string& path, Ring& ring, SnapshotCounters& c) {
+    const auto t0 = std::chrono::steady_clock::now();
+    MappedFile file(path);
+    if (!file.ok()) {
+        SnapshotResult res;
+        res.error = "cannot open " + path;
+        return res;
+    }
+    SnapshotResult res = decodeSnapshot(file.data(), ring, c);
+    res.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return res;
+}
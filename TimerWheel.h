@@ -0,0 +1,187 @@
+// TimerWheel.h
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <utility>
+#include <vector>
+#include "Robot.h"
+#include "Scheduler.h"
+#include "Simulation.h"
+
+enum class TimerAction { Pause, Resume, Remove };
+
+inline const char* timerActionName(TimerAction a) {
+    return a == TimerAction::Pause ? "pause" : a == TimerAction::Resume ? "resume" : "remove";
+}
+
+// Something to do to one robot once the tick counter reaches `tick`
+struct TimerEvent {
+    long long tick = 0;
+    int id = 0;
+    TimerAction action = TimerAction::Pause;
+};
+
+// Hierarchical timing wheel over the tick counter. Level l has 64 slots of
+// 64^l ticks each; an event sits at the lowest level whose current block
+// (64^(l+1) ticks) contains it, and drops a level each time time enters its
+// slot, so every event moves at most kLevels times: O(1) amortized per
+// event with no per-tick cost. Events beyond the top level's block wait in
+// a sorted overflow map until time gets there.
+//
+// nextDue() finds the earliest event through per-level occupancy bitmaps,
+// which lets the turn engines jump straight to it (see runTurnsTimed).
+// Events due on the same tick fire in the order they were scheduled.
+class TimerWheel {
+private:
+    static constexpr int kBits = 6;
+    static constexpr int kSlots = 1 << kBits;
+    static constexpr int kLevels = 6;               // 2^36 ticks before the overflow map
+    static constexpr long long kNever = std::numeric_limits<long long>::max();
+
+    struct Entry {
+        TimerEvent ev;
+        std::uint64_t seq;          // schedule order, for ties
+    };
+
+    std::vector<Entry> slots_[kLevels][kSlots];
+    std::uint64_t occupied_[kLevels] = {};
+    std::multimap<long long, Entry> far_;
+    long long now_ = 0;
+    std::uint64_t seq_ = 0;
+    std::size_t size_ = 0;
+
+    static long long block(long long t, int level) { return t >> (kBits * (level + 1)); }
+    static int slotOf(long long t, int level) { return static_cast<int>((t >> (kBits * level)) & (kSlots - 1)); }
+
+    static int lowestFrom(std::uint64_t bits, int from) {
+        bits &= ~std::uint64_t(0) << from;
+        if (!bits) return -1;
+        int i = 0;
+        while (!(bits & 1)) { bits >>= 1; ++i; }
+        return i;
+    }
+
+    void place(const Entry& e) {
+        const long long t = e.ev.tick;
+        for (int l = 0; l < kLevels; ++l) {
+            if (block(t, l) == block(now_, l)) {
+                int s = slotOf(t, l);
+                slots_[l][s].push_back(e);
+                occupied_[l] |= std::uint64_t(1) << s;
+                return;
+            }
+        }
+        far_.emplace(t, e);
+    }
+
+    std::vector<Entry> take(int level, int slot) {
+        std::vector<Entry> out;
+        out.swap(slots_[level][slot]);
+        occupied_[level] &= ~(std::uint64_t(1) << slot);
+        return out;
+    }
+
+    // Move the clock to t (no event may be earlier) and drop the events in
+    // the slots time has entered down to where they now belong
+    void moveTo(long long t) {
+        now_ = t;
+        while (!far_.empty() && block(far_.begin()->first, kLevels - 1) == block(now_, kLevels - 1)) {
+            Entry e = far_.begin()->second;
+            far_.erase(far_.begin());
+            place(e);
+        }
+        for (int l = kLevels - 1; l > 0; --l) {
+            const int s = slotOf(now_, l);
+            if (occupied_[l] & (std::uint64_t(1) << s))
+                for (const Entry& e : take(l, s)) place(e);
+        }
+    }
+
+public:
+    bool empty() const { return size_ == 0; }
+    std::size_t size() const { return size_; }
+    long long now() const { return now_; }
+
+    // Events for a tick already passed are due at once
+    void schedule(long long tick, int id, TimerAction action) {
+        Entry e{TimerEvent{std::max(tick, now_), id, action}, seq_++};
+        place(e);
+        ++size_;
+    }
+
+    // Tick of the earliest pending event, or LLONG_MAX if none. Lower
+    // levels always hold earlier events than higher ones, so only the first
+    // occupied slot of the first occupied level is scanned.
+    long long nextDue() const {
+        for (int l = 0; l < kLevels; ++l) {
+            int s = lowestFrom(occupied_[l], l == 0 ? slotOf(now_, 0) : 0);
+            if (s < 0) continue;
+            long long best = kNever;
+            for (const Entry& e : slots_[l][s]) best = std::min(best, e.ev.tick);
+            return best;
+        }
+        return far_.empty() ? kNever : far_.begin()->first;
+    }
+
+    // Fire every event due at or before tick t, earliest first, then leave
+    // the clock at t. Returns how many fired. fire(event) may schedule more.
+    template <typename F>
+    std::size_t advance(long long t, F&& fire) {
+        std::size_t fired = 0;
+        for (long long due = nextDue(); due <= t; due = nextDue()) {
+            moveTo(due);
+            std::vector<Entry> batch = take(0, slotOf(due, 0));
+            std::sort(batch.begin(), batch.end(), [](const Entry& a, const Entry& b) { return a.seq < b.seq; });
+            size_ -= batch.size();
+            for (const Entry& e : batch) fire(e.ev);
+            fired += batch.size();
+        }
+        if (t > now_) moveTo(t);
+        return fired;
+    }
+
+    // Drop every event and restart the clock at 0
+    void clear() {
+        for (auto& level : slots_) for (auto& s : level) s.clear();
+        std::fill(std::begin(occupied_), std::end(occupied_), std::uint64_t(0));
+        far_.clear();
+        now_ = 0;
+        size_ = 0;
+    }
+};
+
+// Apply one event to a RobotRing; false if the robot is gone (e.g. it ran
+// out of battery before its event came up)
+template <typename Ring>
+bool applyTimerEvent(Ring& ring, const TimerEvent& ev) {
+    if (ev.action == TimerAction::Remove) return ring.erase(ev.id);
+    return ring.setPaused(ev.id, ev.action == TimerAction::Pause) != nullptr;
+}
+
+// runScheduled up to n ticks, starting at tick counter `now`, stopping at
+// each event boundary to fire that tick's events (applyTimerEvent, then
+// onEvent(event, applied)) and carrying on. Events due at `now` fire first
+// and events due at the final tick fire before returning, so the ring ends
+// up exactly as it is at that tick. Fast-forward runs whole stretches
+// between events. Stops early once nothing is left to run.
+template <typename Ring, typename Sink, typename OnEvent>
+TurnStats runTurnsTimed(Ring& ring, long long n, TimerWheel& timers, long long now, Sink& sink,
+                        SchedulePolicy& policy, TurnMode mode, OnEvent&& onEvent) {
+    auto fire = [&](const TimerEvent& ev) { onEvent(ev, applyTimerEvent(ring, ev)); };
+    TurnStats st;
+    timers.advance(now, fire);
+    while (st.ticks < n) {
+        long long chunk = n - st.ticks;
+        const long long due = timers.nextDue();
+        if (due - (now + st.ticks) < chunk) chunk = due - (now + st.ticks);
+        TurnStats s = runScheduled(ring, chunk, sink, policy, mode);
+        st += s;
+        timers.advance(now + st.ticks, fire);
+        if (s.ticks < chunk) break;             // nothing left to run
+    }
+    return st;
+}
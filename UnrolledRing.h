@@ -0,0 +1,548 @@
+// UnrolledRing.h
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace unrolled {
+// Bit helpers over a chunk's 64-bit live mask (x != 0 where noted)
+inline unsigned lowestBit(std::uint64_t x) {
+#if defined(__GNUC__)
+    return static_cast<unsigned>(__builtin_ctzll(x));
+#else
+    unsigned i = 0;
+    while (!(x & 1)) { x >>= 1; ++i; }
+    return i;
+#endif
+}
+inline unsigned highestBit(std::uint64_t x) {
+#if defined(__GNUC__)
+    return 63u - static_cast<unsigned>(__builtin_clzll(x));
+#else
+    unsigned i = 63;
+    while (!(x >> i)) --i;
+    return i;
+#endif
+}
+inline unsigned popCount(std::uint64_t x) {
+#if defined(__GNUC__)
+    return static_cast<unsigned>(__builtin_popcountll(x));
+#else
+    unsigned n = 0;
+    for (; x; x &= x - 1) ++n;
+    return n;
+#endif
+}
+inline std::uint64_t bit(unsigned s) { return std::uint64_t(1) << s; }
+inline std::uint64_t above(std::uint64_t x, unsigned s) { return s >= 63 ? 0 : x & (~std::uint64_t(0) << (s + 1)); }
+inline std::uint64_t below(std::uint64_t x, unsigned s) { return x & (bit(s) - 1); }
+} // namespace unrolled
+
+// Unrolled circular list: a ring of chunks holding up to K elements each,
+// with the same public API as LinkedList and RingBuffer. Ring order is
+// physical order (chunk by chunk, slot by slot, skipping dead slots)
+// starting at the head slot and wrapping round to the head chunk's slots
+// before it. So:
+//  - rotate() is a bit scan within the chunk and follows one pointer only
+//    every K elements or so;
+//  - pop_front()/erase() destroy in place and leave a dead slot. A chunk
+//    that empties is freed (the last one freed is kept as a spare for the
+//    next chunk needed); sparse chunks are left alone until the whole ring
+//    falls below a quarter full, and then it is repacked in one pass. Dead
+//    slots are reused by appends or reclaimed when a chunk is compacted;
+//  - an append fills the dead slot just behind the head, or the free tail of
+//    the last chunk, or a new chunk. Elements behind the head in its chunk
+//    are moved out of the way first (O(K), once per rotation point);
+//  - splitIntoTwo/splitIntoK/mergeWith splice chunk runs: O(chunks) to find
+//    the cut plus O(K) to cut one chunk, nothing else is moved.
+// Handles are (chunk, slot) and move whenever elements are repacked, which
+// bumps generation(), as with RingBuffer.
+template <typename T, std::size_t K = 32, typename Alloc = std::allocator<T>>
+class UnrolledRing {
+    static_assert(K >= 2 && K <= 64, "chunk size must be 2..64 (one live bit per slot)");
+
+private:
+    struct Chunk {
+        Chunk* next = nullptr;
+        Chunk* prev = nullptr;
+        std::uint64_t live = 0;     // bit s: slot s holds an element
+        unsigned used = 0;          // slots [0, used) have been handed out
+        unsigned count = 0;         // live slots
+        alignas(T) unsigned char raw[K * sizeof(T)];
+
+        T* slot(unsigned s) { return std::launder(reinterpret_cast<T*>(raw + s * sizeof(T))); }
+        void* storage(unsigned s) { return raw + s * sizeof(T); }
+    };
+
+    using ChunkAlloc  = typename std::allocator_traits<Alloc>::template rebind_alloc<Chunk>;
+    using ChunkTraits = std::allocator_traits<ChunkAlloc>;
+
+    ChunkAlloc alloc_;
+    Chunk* head_ = nullptr;         // chunk holding front(); nullptr when empty
+    unsigned slot_ = 0;             // front()'s slot in head_
+    std::size_t sz_ = 0;
+    std::size_t gen_ = 0;           // bumped whenever elements move
+    std::size_t chunks_ = 0;        // chunks in the ring
+    Chunk* spare_ = nullptr;        // last freed chunk, kept for the next newChunk()
+
+    struct Run { Chunk* first; Chunk* last; std::size_t chunks; };  // closed circle of chunks
+
+    Chunk* newChunk() {
+        Chunk* c = spare_;
+        if (c) spare_ = nullptr;
+        else c = ChunkTraits::allocate(alloc_, 1);
+        ChunkTraits::construct(alloc_, c);
+        ++chunks_;
+        return c;
+    }
+    // The chunk's elements must already be destroyed or moved out
+    void freeChunk(Chunk* c) {
+        ChunkTraits::destroy(alloc_, c);
+        --chunks_;
+        if (!spare_) { spare_ = c; return; }
+        ChunkTraits::deallocate(alloc_, c, 1);
+    }
+    void releaseSpare() {
+        if (spare_) ChunkTraits::deallocate(alloc_, spare_, 1);
+        spare_ = nullptr;
+    }
+    static void linkAfter(Chunk* pos, Chunk* c) {
+        c->prev = pos; c->next = pos->next;
+        pos->next->prev = c; pos->next = c;
+    }
+    static void unlink(Chunk* c) { c->prev->next = c->next; c->next->prev = c->prev; }
+
+    template <typename... Args>
+    T& construct(Chunk* c, unsigned s, Args&&... args) {
+        ::new (c->storage(s)) T(std::forward<Args>(args)...);
+        c->live |= unrolled::bit(s);
+        ++c->count;
+        if (s >= c->used) c->used = s + 1;
+        ++sz_;
+        return *c->slot(s);
+    }
+    void destroy(Chunk* c, unsigned s) {
+        c->slot(s)->~T();
+        c->live &= ~unrolled::bit(s);
+        --c->count;
+        --sz_;
+    }
+
+    // Move one element to a free slot; the head follows its element
+    void relocate(Chunk* from, unsigned fs, Chunk* to, unsigned ts) {
+        ::new (to->storage(ts)) T(std::move(*from->slot(fs)));
+        from->slot(fs)->~T();
+        from->live &= ~unrolled::bit(fs); --from->count;
+        to->live |= unrolled::bit(ts); ++to->count;
+        if (ts >= to->used) to->used = ts + 1;
+        if (from == head_ && fs == slot_) { head_ = to; slot_ = ts; }
+    }
+
+    // Pack c's elements into slots [0, count) in order
+    void compact(Chunk* c) {
+        unsigned dst = 0;
+        for (std::uint64_t bits = c->live; bits; bits &= bits - 1, ++dst) {
+            unsigned s = unrolled::lowestBit(bits);
+            if (s != dst) relocate(c, s, c, dst);
+        }
+        c->used = c->count;
+        ++gen_;
+    }
+
+    // Pack the whole ring into as few chunks as it needs, in ring order, and
+    // free the rest. Run by pop_front()/erase() only once the ring is less
+    // than a quarter full, so a draining ring repacks O(log n) times instead
+    // of moving handles (and bumping generation()) on every sparse chunk.
+    void repack() {
+        normalize();
+        Chunk* d = head_;
+        unsigned ds = 0;
+        Chunk* c = head_;
+        do {
+            Chunk* nxt = c->next;
+            for (std::uint64_t bits = c->live; bits; bits &= bits - 1) {
+                const unsigned s = unrolled::lowestBit(bits);
+                if (c != d || s != ds) relocate(c, s, d, ds);
+                if (++ds == K) { d->used = K; d = d->next; ds = 0; }
+            }
+            c = nxt;
+        } while (c != head_);
+        if (ds) { d->used = ds; d = d->next; }
+        while (d != head_) { Chunk* nxt = d->next; unlink(d); freeChunk(d); d = nxt; }
+        ++gen_;
+    }
+
+    void shrink() {
+        if (chunks_ > 1 && sz_ * 4 < chunks_ * K) repack();
+    }
+
+    // Keep x's first k elements, move the rest to a new chunk after x
+    void splitChunk(Chunk* x, unsigned k) {
+        Chunk* y = newChunk();
+        linkAfter(x, y);
+        std::uint64_t bits = x->live;
+        for (unsigned i = 0; i < k; ++i) bits &= bits - 1;
+        for (; bits; bits &= bits - 1) relocate(x, unrolled::lowestBit(bits), y, y->used);
+        x->used = unrolled::highestBit(x->live) + 1;
+        ++gen_;
+    }
+
+    // Make ring order plain chunk order from head_: elements parked before
+    // the head in its chunk (the last ones in ring order) move to the end
+    // of the previous chunk, or to a new chunk in between.
+    void normalize() {
+        if (!head_) return;
+        std::uint64_t move = unrolled::below(head_->live, slot_);
+        if (!move) return;
+        const unsigned m = unrolled::popCount(move);
+        Chunk* t = head_->prev;
+        if (t == head_ || K - t->count < m) {
+            Chunk* e = newChunk();
+            linkAfter(head_->prev, e);
+            t = e;
+        } else if (t->used + m > K) {
+            compact(t);
+        }
+        for (; move; move &= move - 1) relocate(head_, unrolled::lowestBit(move), t, t->used);
+        ++gen_;
+    }
+
+    void stepHead() {
+        std::uint64_t rest = unrolled::above(head_->live, slot_);
+        if (rest) { slot_ = unrolled::lowestBit(rest); return; }
+        head_ = head_->next;
+        slot_ = unrolled::lowestBit(head_->live);
+    }
+
+    template <typename... Args>
+    T& place(Args&&... args) {
+        if (!head_) {
+            Chunk* c = newChunk();
+            c->next = c->prev = c;
+            head_ = c;
+            slot_ = 0;
+            T& x = construct(c, 0, std::forward<Args>(args)...);
+            _checkInvariant();
+            return x;
+        }
+        if (slot_ > 0 && !(head_->live & unrolled::bit(slot_ - 1))) {  // free slot just behind the head
+            T& x = construct(head_, slot_ - 1, std::forward<Args>(args)...);
+            _checkInvariant();
+            return x;
+        }
+        normalize();
+        Chunk* t = head_->prev;                 // last chunk in ring order
+        if (t->used == K) {
+            if (t->count * 4 <= K * 3) compact(t);
+            else { Chunk* e = newChunk(); linkAfter(t, e); t = e; }
+        }
+        T& x = construct(t, t->used, std::forward<Args>(args)...);
+        _checkInvariant();
+        return x;
+    }
+
+    // Cut the first m elements (0 < m <= size(), ring normalized) off as a
+    // closed run of chunks; this ring keeps the rest, still normalized
+    Run detachFront(std::size_t m) {
+        Chunk* a = head_;
+        Chunk* x = a;
+        std::size_t acc = x->count, run = 1;
+        while (acc < m) { x = x->next; acc += x->count; ++run; }
+        if (acc > m) splitChunk(x, x->count - static_cast<unsigned>(acc - m));
+        Chunk* rest = x->next;
+        chunks_ -= run;
+        if (m == sz_) {
+            head_ = nullptr; slot_ = 0; sz_ = 0;
+        } else {
+            Chunk* t = a->prev;
+            t->next = rest; rest->prev = t;
+            head_ = rest;
+            slot_ = unrolled::lowestBit(rest->live);
+            sz_ -= m;
+        }
+        a->prev = x; x->next = a;
+        return {a, x, run};
+    }
+
+    void adopt(Run r, std::size_t m) {
+        head_ = r.first;
+        slot_ = unrolled::lowestBit(r.first->live);
+        sz_ = m;
+        chunks_ = r.chunks;
+        ++gen_;
+    }
+
+    // Visit (chunk, slot) in ring order
+    template <typename F>
+    void forEachSlot(F&& f) const {
+        if (!head_) return;
+        for (std::uint64_t bits = head_->live & ~unrolled::below(head_->live, slot_); bits; bits &= bits - 1)
+            f(head_, unrolled::lowestBit(bits));
+        for (Chunk* c = head_->next; c != head_; c = c->next)
+            for (std::uint64_t bits = c->live; bits; bits &= bits - 1) f(c, unrolled::lowestBit(bits));
+        for (std::uint64_t bits = unrolled::below(head_->live, slot_); bits; bits &= bits - 1)
+            f(head_, unrolled::lowestBit(bits));
+    }
+
+    void _checkInvariant() const {
+#ifndef NDEBUG
+        if (!head_) { assert(sz_ == 0); return; }
+        assert((head_->live & unrolled::bit(slot_)) && "head must be a live slot");
+        assert(head_->count == unrolled::popCount(head_->live) && head_->used <= K);
+        assert(head_->next->prev == head_ && head_->prev->next == head_ && "broken chunk links");
+#ifdef LINKEDLIST_DEEP_CHECK
+        std::size_t n = 0, k = 0;
+        const Chunk* c = head_;
+        do {
+            assert(c->count > 0 && c->count == unrolled::popCount(c->live) && "bad chunk count");
+            assert(c->used <= K && (c->used == 64 || !(c->live >> c->used)) && "live slot past used");
+            assert(c->next->prev == c && "broken chunk links");
+            n += c->count;
+            ++k;
+            c = c->next;
+        } while (c != head_);
+        assert(n == sz_ && "size mismatch");
+        assert(k == chunks_ && "chunk count mismatch");
+#endif
+#endif
+    }
+
+public:
+    using allocator_type = Alloc;
+    using value_type = T;
+    static constexpr std::size_t chunk_size = K;
+
+    // (chunk, slot). Valid until the element is popped or generation()
+    // changes.
+    struct handle {
+        Chunk* chunk = nullptr;
+        unsigned slot = 0;
+        bool operator==(const handle& o) const { return chunk == o.chunk && slot == o.slot; }
+        bool operator!=(const handle& o) const { return !(*this == o); }
+    };
+    static constexpr bool stable_handles = false;
+
+    UnrolledRing() = default;
+    explicit UnrolledRing(const Alloc& alloc) : alloc_(alloc) {}
+    template <typename InputIt,
+              typename = std::enable_if_t<!std::is_integral<InputIt>::value>>
+    UnrolledRing(InputIt first, InputIt last, const Alloc& alloc = Alloc()) : alloc_(alloc) {
+        append_range(first, last);
+    }
+    ~UnrolledRing() { clear(); releaseSpare(); }
+    UnrolledRing(const UnrolledRing&) = delete;
+    UnrolledRing& operator=(const UnrolledRing&) = delete;
+
+    allocator_type get_allocator() const { return allocator_type(alloc_); }
+
+    bool empty() const { return sz_ == 0; }
+    std::size_t size() const { return sz_; }
+
+    // ---- core operations ----
+
+    void append(const T& value) { place(value); }
+    void append(T&& value) { place(std::move(value)); }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args) { return place(std::forward<Args>(args)...); }
+
+    template <typename InputIt>
+    void append_range(InputIt first, InputIt last) {
+        for (; first != last; ++first) place(*first);
+    }
+
+    // Chunks are allocated as they fill; nothing to set aside up front
+    void reserve(std::size_t) {}
+
+    // Destroy the head in place; its chunk is freed once empty
+    bool pop_front() {
+        if (!head_) return false;
+        Chunk* c = head_;
+        destroy(c, slot_);
+        if (!sz_) {
+            freeChunk(c);
+            head_ = nullptr;
+            slot_ = 0;
+            return true;
+        }
+        stepHead();
+        if (c->count == 0) { unlink(c); freeChunk(c); }
+        shrink();
+        _checkInvariant();
+        return true;
+    }
+
+    // Remove the element at h; amortized O(1), may repack the ring
+    void erase(handle h) {
+        if (h.chunk == head_ && h.slot == slot_) { pop_front(); return; }
+        Chunk* c = h.chunk;
+        destroy(c, h.slot);
+        if (c->count == 0) { unlink(c); freeChunk(c); }   // never head_: the head is live
+        shrink();
+        _checkInvariant();
+    }
+
+    // Construct an element right after h in ring order. O(1) when the next
+    // slot is free, else h's chunk is cut after h (O(K)). Returns its handle.
+    template <typename... Args>
+    handle emplace_after(handle h, Args&&... args) {
+        if (h == back_handle()) { place(std::forward<Args>(args)...); return back_handle(); }
+        Chunk* c = h.chunk;
+        const unsigned s = h.slot;
+        if (s + 1 < K && !(c->live & unrolled::bit(s + 1))) {
+            construct(c, s + 1, std::forward<Args>(args)...);
+            _checkInvariant();
+            return {c, s + 1};
+        }
+        Chunk* d = newChunk();
+        linkAfter(c, d);
+        for (std::uint64_t bits = unrolled::above(c->live, s); bits; bits &= bits - 1)
+            relocate(c, unrolled::lowestBit(bits), d, d->used);
+        c->used = s + 1;
+        ++gen_;
+        handle out = s + 1 < K ? handle{c, s + 1} : handle{d, d->used};
+        construct(out.chunk, out.slot, std::forward<Args>(args)...);
+        _checkInvariant();
+        return out;
+    }
+    handle insert_after(handle h, const T& value) { return emplace_after(h, value); }
+    handle insert_after(handle h, T&& value) { return emplace_after(h, std::move(value)); }
+
+    void rotate() {
+        if (sz_ < 2) return;
+        stepHead();
+    }
+
+    T& front() { return *head_->slot(slot_); }
+    const T& front() const { return *head_->slot(slot_); }
+
+    handle front_handle() const { return {head_, slot_}; }
+    handle back_handle() const {
+        std::uint64_t before = unrolled::below(head_->live, slot_);
+        if (before) return {head_, unrolled::highestBit(before)};
+        Chunk* t = head_->prev;
+        return {t, unrolled::highestBit(t->live)};
+    }
+    T& at(handle h) { return *h.chunk->slot(h.slot); }
+    const T& at(handle h) const { return *h.chunk->slot(h.slot); }
+    std::size_t generation() const { return gen_; }
+
+    template <typename F>
+    void forEachHandle(F&& f) {
+        forEachSlot([&](Chunk* c, unsigned s) { f(handle{c, s}, *c->slot(s)); });
+    }
+
+    // Same format as LinkedList::display
+    void display() const {
+        if (!sz_) { std::cout << "[] (empty)\n"; return; }
+        std::cout << "[";
+        const char* sep = "";
+        forEachSlot([&](Chunk* c, unsigned s) { std::cout << sep << *c->slot(s); sep = " -> "; });
+        std::cout << "] (circular)\n";
+    }
+
+    template <typename F>
+    void forEach(F&& f) const {
+        forEachSlot([&](Chunk* c, unsigned s) { f(static_cast<const T&>(*c->slot(s))); });
+    }
+
+    template <typename F>
+    void forEach(F&& f) {
+        forEachSlot([&](Chunk* c, unsigned s) { f(*c->slot(s)); });
+    }
+
+    void clear() {
+        if (head_) {
+            Chunk* stop = head_->prev;
+            for (Chunk* c = head_;;) {
+                Chunk* nxt = c->next;
+                for (std::uint64_t bits = c->live; bits; bits &= bits - 1)
+                    c->slot(unrolled::lowestBit(bits))->~T();
+                const bool last = c == stop;
+                freeChunk(c);
+                if (last) break;
+                c = nxt;
+            }
+        }
+        head_ = nullptr;
+        slot_ = 0;
+        sz_ = 0;
+        ++gen_;
+    }
+
+    // Number of chunks, for fill-factor reporting
+    std::size_t chunks() const { return chunks_; }
+
+    // ---- split & merge ----
+
+    // first gets ceil(n/2), second gets floor(n/2). This ring becomes empty.
+    // Both targets adopt this ring's allocator and take over its chunks.
+    void splitIntoTwo(UnrolledRing& first, UnrolledRing& second) {
+        first.clear(); second.clear();
+        first.releaseSpare(); second.releaseSpare();
+        first.alloc_ = alloc_; second.alloc_ = alloc_;
+        if (!head_) return;
+        normalize();
+        const std::size_t n = sz_, n1 = (n + 1) / 2;
+        first.adopt(detachFront(n1), n1);
+        if (n > n1) second.adopt(detachFront(n - n1), n - n1);
+        ++gen_;
+    }
+
+    // Split into parts.size() rings of consecutive elements, head first; the
+    // first size() % k parts get one extra. This ring becomes empty. Parts
+    // with an equal allocator take over chunk runs, others get the elements
+    // moved over one by one.
+    void splitIntoK(const std::vector<UnrolledRing*>& parts) {
+        for (UnrolledRing* p : parts) p->clear();
+        if (!head_ || parts.empty()) return;
+        const std::size_t base = sz_ / parts.size(), extra = sz_ % parts.size();
+        for (std::size_t i = 0; i < parts.size(); ++i) {
+            UnrolledRing& p = *parts[i];
+            std::size_t n = base + (i < extra ? 1 : 0);
+            if (!n) continue;
+            if (p.alloc_ == alloc_) {
+                normalize();
+                p.adopt(detachFront(n), n);
+            } else {
+                for (; n > 0; --n) { p.emplace_back(std::move(front())); pop_front(); }
+            }
+        }
+        ++gen_;
+    }
+
+    // Splice other's chunks after our tail; 'other' becomes empty. With
+    // distinct allocators the elements are moved over one by one instead.
+    void mergeWith(UnrolledRing& other) {
+        if (other.empty()) return;
+        ++gen_;
+        if (!(alloc_ == other.alloc_) && !empty()) {
+            while (!other.empty()) { place(std::move(other.front())); other.pop_front(); }
+            return;
+        }
+        if (empty()) {
+            releaseSpare();
+            alloc_ = other.alloc_;              // we own no chunks; take theirs
+            head_ = other.head_; slot_ = other.slot_; sz_ = other.sz_;
+            chunks_ = other.chunks_;
+        } else {
+            normalize();
+            other.normalize();
+            Chunk* t = head_->prev;
+            Chunk* ot = other.head_->prev;
+            t->next = other.head_; other.head_->prev = t;
+            ot->next = head_; head_->prev = ot;
+            sz_ += other.sz_;
+            chunks_ += other.chunks_;
+        }
+        other.head_ = nullptr; other.slot_ = 0; other.sz_ = 0; other.chunks_ = 0;
+        ++other.gen_;
+        _checkInvariant();
+    }
+};
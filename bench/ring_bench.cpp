@@ -0,0 +1,363 @@
+// ring_bench.cpp
+//
+// Micro-benchmarks for the ring engines, in the spirit of Google Benchmark
+// but with no dependencies. Each case reports wall time per operation, heap
+// allocations per operation and (on Linux, where perf events are allowed)
+// hardware cache misses per operation.
+//
+// Build from this directory:
+//     g++ -std=c++17 -O2 -DNDEBUG -I.. ring_bench.cpp -o ring_bench -lpthread
+// Run:
+//     ./ring_bench [--max N] [--filter text] [--min-time seconds]
+// --max caps the ring sizes (default 10000000), --filter keeps cases whose
+// name contains text, --min-time is how long each case repeats (default 0.2).
+// Cache misses show as "-" when perf_event_open is not permitted (see
+// /proc/sys/kernel/perf_event_paranoid).
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+#include "FleetGen.h"
+#include "IntrusiveRing.h"
+#include "LinkedList.h"
+#include "RingBuffer.h"
+#include "Robot.h"
+#include "RobotRing.h"
+#include "Simulation.h"
+#include "UnrolledRing.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// ---- allocation counting: every global new in this program goes through here ----
+
+static std::atomic<long long> g_allocs{0};
+
+void* operator new(std::size_t n) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+// kept out of line so GCC does not pair inlined free() with operator new
+#if defined(__GNUC__)
+#define BENCH_NOINLINE __attribute__((noinline))
+#else
+#define BENCH_NOINLINE
+#endif
+BENCH_NOINLINE void operator delete(void* p) noexcept { std::free(p); }
+BENCH_NOINLINE void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+// ---- hardware cache-miss counter (Linux perf events) ----
+
+class CacheMissCounter {
+private:
+    int fd_ = -1;
+
+public:
+    CacheMissCounter() {
+#ifdef __linux__
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof attr;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+    ~CacheMissCounter() {
+#ifdef __linux__
+        if (fd_ >= 0) ::close(fd_);
+#endif
+    }
+    CacheMissCounter(const CacheMissCounter&) = delete;
+    CacheMissCounter& operator=(const CacheMissCounter&) = delete;
+
+    bool ok() const { return fd_ >= 0; }
+    void start() {
+#ifdef __linux__
+        if (fd_ < 0) return;
+        ::ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+        ::ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+    long long stop() {
+        long long v = 0;
+#ifdef __linux__
+        if (fd_ < 0) return 0;
+        ::ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+        if (::read(fd_, &v, sizeof v) != static_cast<ssize_t>(sizeof v)) v = 0;
+#endif
+        return v;
+    }
+};
+
+// ---- harness ----
+
+struct Options {
+    std::size_t maxSize = 10000000;
+    std::string filter;
+    double minTime = 0.2;
+};
+
+// Time spent, allocations and misses inside the measured region of one run
+struct Sample {
+    double seconds = 0;
+    long long allocs = 0;
+    long long misses = 0;
+    long long ops = 0;              // operations the run performed
+
+    Sample& operator+=(const Sample& o) {
+        seconds += o.seconds; allocs += o.allocs; misses += o.misses; ops += o.ops;
+        return *this;
+    }
+};
+
+class Bench {
+private:
+    Options opt_;
+    CacheMissCounter perf_;
+
+public:
+    explicit Bench(Options opt) : opt_(std::move(opt)) {
+        std::printf("%-46s %10s %12s %11s %11s\n", "Benchmark", "Size", "ns/op", "allocs/op", "misses/op");
+        std::printf("%s\n", std::string(94, '-').c_str());
+    }
+
+    const Options& options() const { return opt_; }
+
+    // Measure body(ops) between setup() and teardown(), neither of which is
+    // timed; repeated until minTime has been spent in body, or kMaxRuns
+    // times (O(1) bodies would otherwise spend minutes in setup).
+    template <typename Setup, typename Body, typename Teardown>
+    void run(const std::string& name, std::size_t size, Setup setup, Body body, Teardown teardown) {
+        if (!opt_.filter.empty() && name.find(opt_.filter) == std::string::npos) return;
+        const int kMaxRuns = 10000;
+        Sample total;
+        int runs = 0;
+        do {
+            setup();
+            Sample s;
+            const long long a0 = g_allocs.load(std::memory_order_relaxed);
+            perf_.start();
+            const auto t0 = std::chrono::steady_clock::now();
+            s.ops = body();
+            s.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+            s.misses = perf_.stop();
+            s.allocs = g_allocs.load(std::memory_order_relaxed) - a0;
+            teardown();
+            total += s;
+        } while (total.seconds < opt_.minTime && ++runs < kMaxRuns);
+        const double ops = total.ops > 0 ? static_cast<double>(total.ops) : 1.0;
+        char misses[32] = "-";
+        if (perf_.ok()) std::snprintf(misses, sizeof misses, "%.3f", total.misses / ops);
+        std::printf("%-46s %10zu %12.2f %11.3f %11s\n", name.c_str(), size,
+                    total.seconds * 1e9 / ops, total.allocs / ops, misses);
+        std::fflush(stdout);
+    }
+};
+
+inline Robot benchRobot(int i) { return Robot(i, "r", 1000000000, 1); }
+
+// ---- engine operations ----
+
+template <typename Engine>
+void engineCases(Bench& b, const char* engine, std::size_t n) {
+    const std::string tag = std::string("/") + engine;
+    Engine ring;
+    auto fill = [&] { ring.clear(); ring.reserve(n); for (std::size_t i = 0; i < n; ++i) ring.append(benchRobot(static_cast<int>(i))); };
+    auto none = [] {};
+    const long long rotations = static_cast<long long>(n < 1000000 ? 1000000 : n);
+
+    b.run("append" + tag, n, [&] { ring.clear(); }, [&] {
+        for (std::size_t i = 0; i < n; ++i) ring.append(benchRobot(static_cast<int>(i)));
+        return static_cast<long long>(n);
+    }, none);
+    b.run("pop_front" + tag, n, fill, [&] {
+        while (ring.pop_front()) {}
+        return static_cast<long long>(n);
+    }, none);
+    b.run("rotate" + tag, n, fill, [&] {
+        for (long long i = 0; i < rotations; ++i) ring.rotate();
+        return rotations;
+    }, none);
+    // round-robin with arrivals: every append lands just behind a head that
+    // has moved since the last one; ns/op is per rotate + append pair
+    b.run("rotate+append" + tag, n, fill, [&] {
+        for (std::size_t i = 0; i < n; ++i) {
+            ring.rotate();
+            ring.append(benchRobot(static_cast<int>(n + i)));
+        }
+        return static_cast<long long>(n);
+    }, none);
+    b.run("forEach" + tag, n, fill, [&] {
+        long long sum = 0;
+        ring.forEach([&](const Robot& r) { sum += r.battery; });
+        if (sum == 42) std::puts("");           // keep the walk alive
+        return static_cast<long long>(n);
+    }, none);
+
+    Engine first(ring.get_allocator()), second(ring.get_allocator());
+    b.run("splitIntoTwo" + tag, n, fill, [&] {
+        ring.splitIntoTwo(first, second);
+        return 1LL;
+    }, [&] { first.clear(); second.clear(); });
+    b.run("mergeWith" + tag, n, [&] { fill(); ring.splitIntoTwo(first, second); }, [&] {
+        first.mergeWith(second);
+        return 1LL;
+    }, [&] { first.clear(); second.clear(); });
+    b.run("clear" + tag, n, fill, [&] {
+        ring.clear();
+        return static_cast<long long>(n);
+    }, none);
+}
+
+// Full ticks as runOneTurn does them (paused skips, drain, removal) without
+// console output; pausedEvery > 0 pauses every that-many-th robot
+template <typename Engine>
+void simulationCases(Bench& b, const char* engine, std::size_t n) {
+    const std::string tag = std::string("/") + engine;
+    RobotRing<Engine> ring;
+    const long long ticks = static_cast<long long>(n < 1000000 ? 1000000 : n);
+    auto fill = [&](int battery, int pausedEvery) {
+        ring.clear();
+        ring.reserve(n);
+        for (std::size_t i = 0; i < n; ++i)
+            ring.append(Robot(static_cast<int>(i), "r", battery, 1, pausedEvery && i % pausedEvery == 0));
+    };
+    auto none = [] {};
+    auto tick = [&] {
+        long long done = 0;
+        for (; done < ticks; ++done)
+            if (!stepTurn(ring, [](TurnResult, const Robot&, int) {})) break;
+        return done;
+    };
+
+    b.run("runOneTurn" + tag, n, [&] { fill(1000000000, 0); }, tick, none);
+    b.run("runOneTurn/paused10%" + tag, n, [&] { fill(1000000000, 10); }, tick, none);
+    // every robot leaves after ~ticks/n turns: removal-heavy
+    const int shortLife = static_cast<int>(ticks / static_cast<long long>(n) / 2 + 1);
+    b.run("runOneTurn/removals" + tag, n, [&] { fill(shortLife, 0); }, tick, none);
+    b.run("runTurns/fastForward" + tag, n, [&] { fill(shortLife, 0); }, [&] {
+        return runTurns(ring, ticks, nullptr, TurnMode::FastForward).ticks;
+    }, none);
+}
+
+// The FleetGen load-test scenarios end to end on a seeded fleet of n robots
+// (fast-forward round-robin); ns/op is per tick
+template <typename Engine>
+void scenarioCases(Bench& b, const char* engine, std::size_t n) {
+    const std::string tag = std::string("/") + engine;
+    RobotRing<Engine> ring;
+    const long long ticks = static_cast<long long>(n < 1000000 ? 1000000 : n);
+    for (Scenario s : {Scenario::MassRemoval, Scenario::MostlyPaused, Scenario::SplitMerge}) {
+        FleetSpec spec;
+        spec.robots = n;
+        spec = scenarioFleet(s, spec);
+        b.run(std::string("scenario/") + scenarioName(s) + tag, n, [&] {
+            ring.clear();
+            int nextId = 1;
+            buildFleet(ring, spec, nextId);
+        }, [&] {
+            return runScenario(s, ring, ticks).turns.ticks;
+        }, [] {});
+    }
+}
+
+// The intrusive ring over a caller-owned fleet array: linking, unlinking,
+// split and merge never allocate
+void intrusiveCases(Bench& b, std::size_t n) {
+    const std::string tag = "/IntrusiveRing";
+    std::vector<HookedRobot> fleet;
+    fleet.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) fleet.emplace_back(static_cast<int>(i), "r", 1000000000, 1);
+    ActiveRing ring, first, second;
+    auto fill = [&] { ring.clear(); ring.append_range(fleet.begin(), fleet.end()); };
+    auto none = [] {};
+    const long long rotations = static_cast<long long>(n < 1000000 ? 1000000 : n);
+
+    b.run("append" + tag, n, [&] { ring.clear(); }, [&] {
+        for (HookedRobot& r : fleet) ring.append(r);
+        return static_cast<long long>(n);
+    }, none);
+    b.run("pop_front" + tag, n, fill, [&] {
+        while (ring.pop_front()) {}
+        return static_cast<long long>(n);
+    }, none);
+    b.run("rotate" + tag, n, fill, [&] {
+        for (long long i = 0; i < rotations; ++i) ring.rotate();
+        return rotations;
+    }, none);
+    b.run("forEach" + tag, n, fill, [&] {
+        long long sum = 0;
+        ring.forEach([&](const Robot& r) { sum += r.battery; });
+        if (sum == 42) std::puts("");
+        return static_cast<long long>(n);
+    }, none);
+    b.run("splitIntoTwo" + tag, n, fill, [&] {
+        ring.splitIntoTwo(first, second);
+        return 1LL;
+    }, [&] { first.clear(); second.clear(); });
+    b.run("mergeWith" + tag, n, [&] { fill(); ring.splitIntoTwo(first, second); }, [&] {
+        first.mergeWith(second);
+        return 1LL;
+    }, [&] { first.clear(); second.clear(); });
+    b.run("runOneTurn" + tag, n, fill, [&] {
+        long long done = 0;
+        for (; done < rotations; ++done)
+            if (!stepTurn(ring, [](TurnResult, const Robot&, int) {})) break;
+        return done;
+    }, [&] { for (HookedRobot& r : fleet) r.battery = 1000000000; });
+    ring.clear();
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--max" && i + 1 < argc) opt.maxSize = std::strtoull(argv[++i], nullptr, 10);
+        else if (a == "--filter" && i + 1 < argc) opt.filter = argv[++i];
+        else if (a == "--min-time" && i + 1 < argc) opt.minTime = std::strtod(argv[++i], nullptr);
+        else {
+            std::fprintf(stderr, "usage: %s [--max N] [--filter text] [--min-time seconds]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    using HeapList = LinkedList<Robot, std::allocator<Robot>>;  // one new/delete per node
+    using PoolList = LinkedList<Robot>;                         // slab pool (default)
+    using PoolList2 = LinkedList<Robot, PoolAllocator<Robot>, DoublyLinked>;
+    using Array    = RingBuffer<Robot>;
+    using Unrolled = UnrolledRing<Robot>;                       // 32 robots per chunk
+
+    Bench b(opt);
+    for (std::size_t n = 10; n <= opt.maxSize; n *= 10) {
+        engineCases<HeapList>(b, "LinkedList<heap>", n);
+        engineCases<PoolList>(b, "LinkedList<pool>", n);
+        engineCases<PoolList2>(b, "LinkedList<pool,doubly>", n);
+        engineCases<Array>(b, "RingBuffer", n);
+        engineCases<Unrolled>(b, "UnrolledRing", n);
+        simulationCases<HeapList>(b, "LinkedList<heap>", n);
+        simulationCases<PoolList>(b, "LinkedList<pool>", n);
+        simulationCases<PoolList2>(b, "LinkedList<pool,doubly>", n);
+        simulationCases<Array>(b, "RingBuffer", n);
+        simulationCases<Unrolled>(b, "UnrolledRing", n);
+        scenarioCases<HeapList>(b, "LinkedList<heap>", n);
+        scenarioCases<PoolList>(b, "LinkedList<pool>", n);
+        scenarioCases<Array>(b, "RingBuffer", n);
+        scenarioCases<Unrolled>(b, "UnrolledRing", n);
+        intrusiveCases(b, n);
+    }
+    return 0;
+}
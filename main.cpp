@@ -1,31 +1,54 @@
 #include <iostream>
 #include <string>
 #include <limits>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
 #include "linkedlist.h"
+#include "RingBuffer.h"
+#include "Robot.h"
+#include "RobotRing.h"
+#include "Simulation.h"
+#include "FleetIO.h"
+#include "Snapshot.h"
+#include "ParallelSim.h"
+#include "Shard.h"
+#include "RobotQueue.h"
+#include "EventLog.h"
+#include "RingView.h"
+#include "Scheduler.h"
+#include "TimerWheel.h"
+#include "Instrument.h"
+#include "FleetGen.h"
+#include "UnrolledRing.h"
 
+// Ring engine, chosen at compile time: -DROBOT_RING_ARRAY for the
+// contiguous RingBuffer, otherwise the node-based LinkedList, doubly linked
+// so robots retire out of turn in O(1) (-DROBOT_RING_SINGLY for the
+// smaller singly linked nodes, -DROBOT_RING_UNROLLED for chunks of 32).
+#ifdef ROBOT_RING_ARRAY
+using Ring = RobotRing<RingBuffer<Robot>>;
+#elif defined(ROBOT_RING_UNROLLED)
+using Ring = RobotRing<UnrolledRing<Robot>>;
+#elif defined(ROBOT_RING_SINGLY)
+using Ring = RobotRing<LinkedList<Robot>>;
+#else
+using Ring = RobotRing<LinkedList<Robot, PoolAllocator<Robot>, DoublyLinked>>;
+#endif
 
-struct Robot {
-    int id;
-    std::string name;
-    int battery;   // remaining
-    int drain;     // per turn (Quantum)
-    bool paused;
-
-    Robot(int id_, std::string n, int b, int d = 1, bool p = false)
-        : id(id_), name(std::move(n)), battery(b), drain(d), paused(p) {}
-};
-
-
-std::ostream& operator<<(std::ostream& os, const Robot& r) {
-    os << "Robot(" << r.name << ", Battery=" << r.battery << ")";
-    return os;
-}
-
-static void printMenu(const LinkedList<Robot>& ring, long long score, int quantum) {
+static void printMenu(const Ring& ring, long long score, int quantum, const SchedulePolicy& policy) {
     std::cout << "\n=== Robot Relay Ring ===\n";
-    std::cout << "Robots: "  << ring.size() << "\n";
+    std::cout << "Robots: "  << ring.robotCount() << "\n";
     std::cout << "Score: "   << score       << "\n";
     std::cout << "Quantum: " << quantum     << "\n";
+    if (ring.scheduleMode() == ScheduleMode::Parked)
+        std::cout << "Paused robots: parked (" << ring.parkedCount() << ")\n";
+    if (!std::holds_alternative<RoundRobin>(policy))
+        std::cout << "Scheduling: " << policyName(policy) << "\n";
     std::cout <<
         "1) Add robot\n"
         "2) Run 1 turn\n"
@@ -35,90 +58,549 @@ static void printMenu(const LinkedList<Robot>& ring, long long score, int quantu
         "6) Split ring into two\n"
         "7) Merge rings\n"
         "8) Stats report\n"
+        "9) Toggle parking of paused robots\n"
+        "10) Import robots from CSV file\n"
+        "11) Save snapshot\n"
+        "12) Restore snapshot\n"
+        "13) Run N turns in parallel on K sub-rings\n"
+        "14) Register robots from a background producer\n"
+        "15) Set tick log level\n"
+        "16) Choose scheduling policy\n"
+        "17) Schedule pause/resume/removal at a future tick\n"
+        "18) Retire robot now\n"
         "0) Exit\n"
         "Choose: ";
 }
 
 // Add robot: prompt for name + battery; drain = quantum by default
-static void addRobot(LinkedList<Robot>& ring, int& nextId, long long& score, int quantum) {
+static void addRobot(Ring& ring, int& nextId, long long& score, int quantum) {
     std::string name; int bat;
     std::cout << "Robot name: "; std::cin >> name;
     std::cout << "Battery: ";    std::cin >> bat;
-    ring.append(Robot(nextId++, name, bat, quantum));
+    ring.emplace_back(nextId++, name, bat, quantum);
     score += 2; // scoring per spec
 }
 
+// Bulk import (name,battery[,drain[,paused]] per line); +2 per robot like addRobot
+static void importRobots(Ring& ring, int& nextId, long long& score, int quantum) {
+    std::string path;
+    std::cout << "CSV path: "; std::cin >> path;
+    FleetLoadResult res = loadFleetCsv(path, ring, nextId, quantum);
+    if (!res.ok) { std::cout << "Import failed: " << res.error << "\n"; return; }
+    score += 2 * static_cast<long long>(res.loaded);
+    std::cout << "Loaded " << res.loaded << " robots";
+    if (res.skipped) std::cout << " (" << res.skipped << " malformed lines skipped)";
+    std::cout << " in " << res.seconds * 1000.0 << " ms, "
+              << static_cast<long long>(res.robotsPerSecond()) << " robots/s\n";
+}
+
+// Snapshot save/restore of the ring plus score, ticks and nextId
+static void saveRing(const Ring& ring, long long score, long long ticks, int nextId) {
+    std::string path;
+    std::cout << "Snapshot path: "; std::cin >> path;
+    SnapshotCounters c;
+    c.score = score; c.ticks = ticks; c.nextId = nextId;
+    SnapshotResult res = saveSnapshot(path, ring, c);
+    if (!res.ok) { std::cout << "Save failed: " << res.error << "\n"; return; }
+    std::cout << "Saved " << res.robots << " robots in " << res.seconds * 1000.0 << " ms\n";
+}
+
+static bool restoreRing(Ring& ring, long long& score, long long& ticks, int& nextId) {
+    std::string path;
+    std::cout << "Snapshot path: "; std::cin >> path;
+    SnapshotCounters c;
+    SnapshotResult res = loadSnapshot(path, ring, c);
+    if (!res.ok) { std::cout << "Restore failed: " << res.error << "\n"; return false; }
+    score = c.score; ticks = c.ticks; nextId = c.nextId;
+    std::cout << "Restored " << res.robots << " robots in " << res.seconds * 1000.0 << " ms\n";
+    return true;
+}
+
+// Robots registered by producer threads join between ticks, +2 each like addRobot
+static void joinPending(Ring& ring, RobotQueue& pending, int& nextId, long long& score) {
+    std::size_t n = ingestPending(pending, ring, nextId);
+    if (!n) return;
+    score += 2 * static_cast<long long>(n);
+    std::cout << "Joined " << n << " queued robots\n";
+}
+
+// Start a producer thread that queues count robots; they join the ring on
+// the next tick boundary (option 2 or 3) without the menu waiting for it
+static void startProducer(std::vector<std::thread>& producers, RobotQueue& pending, int quantum) {
+    int count, bat;
+    std::cout << "Robots to register: "; std::cin >> count;
+    std::cout << "Battery: ";            std::cin >> bat;
+    std::size_t tag = producers.size() + 1;
+    producers.emplace_back([&pending, count, bat, quantum, tag] {
+        for (int i = 0; i < count; ++i)
+            pending.push(PendingRobot{"p" + std::to_string(tag) + "-" + std::to_string(i + 1),
+                                      bat, quantum, false});
+    });
+    std::cout << "Producer " << tag << " started\n";
+}
+
 // Display the ring
-static void displayRing(const LinkedList<Robot>& ring) {
+static void displayRing(const Ring& ring) {
     ring.display();
 }
 
-// One turn of round-robin (Quantum battery drain per turn; paused => skip)
-static int runOneTurn(LinkedList<Robot>& ring) {
-    if (ring.size() == 0) { std::cout << "No robots.\n"; return 0; }
-
-    Robot& cur = ring.front();             // head robot
-    if (cur.paused) {                      // paused → skip and rotate
-        std::cout << "Skipped (paused): " << cur << "\n";
-        ring.rotate();
-        return 1;                          // still a processed tick
+// Every tick-engine call goes through here: run(k, done) runs k more ticks
+// (done already run) and returns their stats. Instrumented builds time the
+// calls for Instrument.h; stepped runs go one tick per call so the latency
+// histogram sees real per-tick times, fast-forward runs count as their mean.
+template <typename Run>
+static TurnStats probed(long long n, TurnMode mode, Run&& run) {
+#ifdef ROBOT_RING_INSTRUMENT
+    using clock = std::chrono::steady_clock;
+    const long long each = mode == TurnMode::Step ? 1 : std::max(n, 1LL);
+    TurnStats st;
+    while (st.ticks < n) {
+        const long long k = std::min(each, n - st.ticks);
+        const auto t0 = clock::now();
+        TurnStats s = run(k, st.ticks);
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - t0).count();
+        instrument::recordRun(s.ticks, s.skipped, s.removed, static_cast<std::uint64_t>(ns));
+        st += s;
+        if (s.ticks < k) break;                 // nothing left to run
     }
+    return st;
+#else
+    (void)mode;
+    return run(n, 0LL);
+#endif
+}
+
+// One turn under the scheduling policy (round-robin by default: Quantum
+// battery drain per turn; paused => skip)
+static int runOneTurn(Ring& ring, EventLog& events, SchedulePolicy& policy) {
+    if (ring.robotCount() == 0) { std::cout << "No robots.\n"; return 0; }
+    TurnStats one;
+    auto record = [&](TurnResult what, const Robot& r, int before) {
+        if (what == TurnResult::Skipped) ++one.skipped;
+        else if (what == TurnResult::Removed) ++one.removed;
+        if (events.wantsTicks() || (events.wantsRemovals() && what == TurnResult::Removed))
+            events.record(what, r, before);
+    };
+    const int gained = static_cast<int>(probed(1, TurnMode::Step, [&](long long, long long) {
+        one.score = std::visit([&](auto& p) { return p.step(ring, record); }, policy);
+        one.ticks = one.score ? 1 : 0;
+        return one;
+    }).score);
+    events.flush();
+    if (!gained) std::cout << "No active robots (all parked).\n";
+    return gained;
+}
+
+// Timer events print between tick lines, so the log is flushed first
+static void reportTimer(EventLog& events, const TimerEvent& ev, bool applied) {
+    events.flush();
+    std::cout << "Timer: " << timerActionName(ev.action) << " robot " << ev.id
+              << " at tick " << ev.tick << (applied ? "" : " (robot gone)") << "\n";
+}
+
+static void fireTimers(Ring& ring, TimerWheel& timers, long long ticks, EventLog& events) {
+    timers.advance(ticks, [&](const TimerEvent& ev) { reportTimer(events, ev, applyTimerEvent(ring, ev)); });
+}
 
-    int before = cur.battery;
-    cur.battery -= cur.drain;
-    std::cout << "Tick: " << cur.name << " battery " << before
-              << " -> " << cur.battery << "\n";
+static void scheduleTimer(TimerWheel& timers, long long ticks) {
+    int id, action; long long at;
+    std::cout << "Robot id: ";                             std::cin >> id;
+    std::cout << "Action (0 pause, 1 resume, 2 remove): "; std::cin >> action;
+    std::cout << "At tick: ";                              std::cin >> at;
+    if (action < 0 || action > 2) { std::cout << "Unknown action.\n"; return; }
+    if (at < ticks) at = ticks;
+    timers.schedule(at, id, static_cast<TimerAction>(action));
+    std::cout << "Scheduled " << timerActionName(static_cast<TimerAction>(action)) << " of robot "
+              << id << " at tick " << at << " (now " << ticks << ")\n";
+}
 
-    if (cur.battery <= 0) {                // removal occurs at head
-        std::cout << "Removed: " << cur << " (returned to dock)\n";
-        ring.pop_front();                   // do NOT rotate after removal
-        return 1 + 3;                       // +1 tick, +3 removal bonus
+// Run N turns in one batch. Tick lines go through the event log (written
+// by its formatter thread); large N fast-forwards (round-robin only), logs
+// removals at most, and prints a summary. Queued robots join before the
+// batch and, for large round-robin N without timers, between slices of it.
+// Timers due within the batch fire on their exact tick.
+static void runManyTurns(Ring& ring, long long n, long long& ticks, long long& score,
+                         RobotQueue& pending, int& nextId, EventLog& events,
+                         SchedulePolicy& policy, TimerWheel& timers) {
+    const long long kEchoLimit = 1000;     // above this, no per-tick lines
+    const long long kIngestSlice = 1 << 16;
+    auto timed = [&](TurnMode mode) {
+        return probed(n, mode, [&](long long k, long long done) {
+            return runTurnsTimed(ring, k, timers, ticks + done, events, policy, mode,
+                                 [&](const TimerEvent& ev, bool applied) { reportTimer(events, ev, applied); });
+        });
+    };
+    auto scheduled = [&](TurnMode mode) {
+        return probed(n, mode, [&](long long k, long long) { return runScheduled(ring, k, events, policy); });
+    };
+    joinPending(ring, pending, nextId, score);
+    if (n <= kEchoLimit) {
+        TurnStats st = timers.empty() ? scheduled(TurnMode::Step) : timed(TurnMode::Step);
+        events.flush();
+        ticks += st.ticks;
+        score += st.score;
+        return;
+    }
+    const LogLevel level = events.level();
+    if (level == LogLevel::All) events.setLevel(LogLevel::Removals);
+    TurnStats st;
+    std::size_t joined = 0;
+    if (!timers.empty()) {
+        st = timed(TurnMode::FastForward);     // stops at every timer tick
+    } else if (std::holds_alternative<RoundRobin>(policy)) {
+        st = probed(n, TurnMode::FastForward, [&](long long k, long long) {
+            IngestStats in = runTurnsIngesting(ring, k, pending, nextId, kIngestSlice,
+                                               TurnMode::FastForward, events);
+            joined += in.joined;
+            return in.turns;
+        });
     } else {
-        ring.rotate();                      // alive → move to next
-        return 1;
+        st = scheduled(TurnMode::Step);
     }
+    events.flush();
+    events.setLevel(level);
+    std::cout << "Ran " << st.ticks << " ticks: " << st.removed << " removed, "
+              << st.skipped << " skipped, score +" << st.score << "\n";
+    if (joined) std::cout << "Joined " << joined << " queued robots\n";
+    ticks += st.ticks;
+    score += st.score + 2 * static_cast<long long>(joined);
 }
 
-// Pause/Resume by id (linear search in the circle)
-static void togglePauseById(LinkedList<Robot>& ring, int id) {
-    if (ring.size() == 0) { std::cout << "No robots.\n"; return; }
-    bool found = false;
-    for (std::size_t i = 0; i < ring.size(); ++i) {
-        if (ring.front().id == id) {
-            ring.front().paused = !ring.front().paused;
-            std::cout << (ring.front().paused ? "Paused: " : "Resumed: ")
-                      << ring.front() << "\n";
-            found = true;
-            break;
-        }
-        ring.rotate();
+// Pick the policy for options 2 and 3 (option 13 always runs round-robin)
+static void choosePolicy(SchedulePolicy& policy) {
+    int which;
+    std::cout << "Policy (0 round-robin, 1 lowest battery first, 2 battery-weighted, "
+                 "3 deficit round-robin): ";
+    std::cin >> which;
+    if (which == 1) policy = LowestBatteryFirst{};
+    else if (which == 2) policy = BatteryWeighted{};
+    else if (which == 3) {
+        long long q; std::cout << "Quantum per round: "; std::cin >> q;
+        policy = DeficitRoundRobin(q);
     }
-    if (!found) std::cout << "Not found.\n";
+    else policy = RoundRobin{};
+    std::cout << "Scheduling: " << policyName(policy) << "\n";
 }
 
-// Stats report: count + average battery (simple baseline)
-static void statsReport(const LinkedList<Robot>& ring, long long ticks, long long score) {
-    int count = static_cast<int>(ring.size());
-    long long sum = 0;
-    ring.forEach([&](const Robot& r){ sum += r.battery; });
-    double avg = (count ? static_cast<double>(sum) / count : 0.0);
+// Split into K sub-rings, run each for N ticks on the worker pool, merge
+// back in order (same result for any thread count; see ParallelSim)
+static void runParallel(Ring& ring, ParallelSim<Ring>& sim, long long& ticks, long long& score) {
+    long long k, n;
+    std::cout << "Sub-rings: "; std::cin >> k;
+    std::cout << "Turns: ";     std::cin >> n;
+    if (ring.robotCount() == 0) { std::cout << "No robots.\n"; return; }
+    if (k < 1) k = 1;
+    sim.split(ring, static_cast<std::size_t>(k));
+    probed(n, TurnMode::FastForward, [&](long long m, long long) { return sim.run(m); });
+    for (std::size_t i = 0; i < sim.parts(); ++i) {
+        const TurnStats& p = sim.partStats(i);
+        std::cout << "Sub-ring " << i + 1 << ": " << sim.part(i).robotCount() << " robots left, "
+                  << p.removed << " removed, score +" << p.score << "\n";
+    }
+    TurnStats st = sim.merge(ring);
+    std::cout << "Ran " << k << " x " << n << " ticks (" << sim.threads() << " worker threads): "
+              << st.removed << " removed, " << st.skipped << " skipped, score +" << st.score << "\n";
+    ticks += st.ticks;
+    score += st.score;
+}
+
+// Pause/Resume by id (O(1) index lookup; ring order is left alone)
+static void togglePauseById(Ring& ring, int id) {
+    if (ring.robotCount() == 0) { std::cout << "No robots.\n"; return; }
+    const Robot* r = ring.find(id);
+    if (!r) { std::cout << "Not found.\n"; return; }
+    r = ring.setPaused(id, !r->paused);
+    std::cout << (r->paused ? "Paused: " : "Resumed: ") << *r << "\n";
+}
+
+// Take a robot out of the ring by id, out of turn (no dock bonus)
+static void retireById(Ring& ring, int id) {
+    const Robot* r = ring.find(id);
+    if (!r) { std::cout << "Not found.\n"; return; }
+    std::cout << "Retired: " << *r << "\n";
+    ring.erase(id);
+}
 
-    std::cout << "Robots: " << count << "\n";
-    std::cout << "Avg battery: " << avg << "\n";
+// Stats report: read from the ring's running aggregates (O(1))
+static void statsReport(const Ring& ring, long long ticks, long long score) {
+    const FleetStats& st = ring.stats();
+
+    std::cout << "Robots: " << st.count() << "\n";
+    std::cout << "Avg battery: " << st.avgBattery() << "\n";
+    std::cout << "Min/Max battery: " << st.minBattery() << " / " << st.maxBattery() << "\n";
+    std::cout << "Active: " << st.active() << ", Paused: " << st.paused() << "\n";
     std::cout << "Ticks: " << ticks << "\n";
     std::cout << "Score: " << score << "\n";
+#ifdef ROBOT_RING_INSTRUMENT
+    instrument::report(std::cout);
+#endif
+}
+
+// ---- headless mode: ./relay --robots N --turns T ... (see headlessUsage) ----
+
+struct HeadlessOptions {
+    FleetSpec fleet;                        // generated fleet (size, distributions, seed)
+    Scenario scenario = Scenario::None;
+    int quantum = 1;                        // drain for CSV fleets
+    long long turns = 1000000;
+    LogLevel verbosity = LogLevel::Off;
+    TurnMode mode = TurnMode::FastForward;
+    SchedulePolicy policy;                  // round-robin unless --policy
+    bool parking = false;
+    std::string csv;                        // load this fleet instead of generating one
+    double progress = 0;                    // seconds between progress lines; 0 = none
+    std::string statsJson;                  // instrumentation dump ("-" = stdout)
+    std::size_t shards = 0;                 // shard processes; 0 = run in this process
+};
+
+static void headlessUsage(const char* argv0) {
+    std::cerr <<
+        "usage: " << argv0 << " [options]   (no options: interactive menu)\n"
+        "  --robots N          fleet size (default 1000)\n"
+        "  --battery DIST      battery distribution (default 100): LO[:HI] or uniform:LO:HI\n"
+        "                      (uniform), zipf:LO:HI[:S] (P ~ 1/rank^S, default S 1),\n"
+        "                      bimodal:LO:HI[:PCT] (PCT% near HI, the rest near LO)\n"
+        "  --drain DIST        drain per turn, same forms (default 1)\n"
+        "  --quantum Q         drain per turn, for generated and CSV fleets (default 1)\n"
+        "  --paused PCT        percent of robots starting paused (default 0)\n"
+        "  --turns N           ticks to run (default 1000000)\n"
+        "  --verbosity V       0 summary only, 1 removals, 2 every tick (default 0)\n"
+        "  --step              tick by tick (default: fast-forward where possible)\n"
+        "  --policy P          rr (default), lowest, weighted or drr[:QUANTUM]\n"
+        "  --parking           park paused robots (option 9)\n"
+        "  --seed S            generator seed (default 1; same fleet on every platform)\n"
+        "  --scenario NAME     canned load test: mass-removal, mostly-paused or split-merge\n"
+        "                      (sets the fleet shape; later options override it)\n"
+        "  --csv PATH          load the fleet from CSV instead of generating it\n"
+        "  --progress SECS     progress line on stderr every SECS seconds\n"
+        "  --shards K          run the ring as K shard processes, rebalanced between slices\n"
+        "  --stats-json PATH   instrumentation counters and histograms as JSON (\"-\": stdout;\n"
+        "                      needs a -DROBOT_RING_INSTRUMENT build)\n";
 }
 
-int main() {
-    LinkedList<Robot> ring;        // main working ring
-    LinkedList<Robot> a, b;        // for split/merge menu options
+static bool parseHeadless(int argc, char** argv, HeadlessOptions& o, std::string& err) {
+    auto num = [&](int& i, long long lo, long long& out) {
+        if (i + 1 >= argc) { err = std::string(argv[i]) + " needs a value"; return false; }
+        char* end = nullptr;
+        out = std::strtoll(argv[++i], &end, 10);
+        if (*end || out < lo) { err = std::string("bad value for ") + argv[i - 1]; return false; }
+        return true;
+    };
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        long long v = 0;
+        if (a == "--robots") { if (!num(i, 0, v)) return false; o.fleet.robots = static_cast<std::size_t>(v); }
+        else if (a == "--quantum") { if (!num(i, 0, v)) return false; o.quantum = static_cast<int>(v);
+                                     o.fleet.drain = FleetDist::uniform(o.quantum, o.quantum); }
+        else if (a == "--paused") { if (!num(i, 0, v) || v > 100) { err = "bad value for --paused"; return false; } o.fleet.pausedPct = static_cast<int>(v); }
+        else if (a == "--turns") { if (!num(i, 0, v)) return false; o.turns = v; }
+        else if (a == "--verbosity") { if (!num(i, 0, v) || v > 2) { err = "bad value for --verbosity"; return false; }
+                                       o.verbosity = v == 0 ? LogLevel::Off : v == 1 ? LogLevel::Removals : LogLevel::All; }
+        else if (a == "--seed") { if (!num(i, 0, v)) return false; o.fleet.seed = static_cast<std::uint64_t>(v); }
+        else if (a == "--step") o.mode = TurnMode::Step;
+        else if (a == "--parking") o.parking = true;
+        else if (a == "--battery" && i + 1 < argc) {
+            if (!parseFleetDist(argv[++i], o.fleet.battery)) { err = "bad value for --battery"; return false; }
+        }
+        else if (a == "--drain" && i + 1 < argc) {
+            if (!parseFleetDist(argv[++i], o.fleet.drain)) { err = "bad value for --drain"; return false; }
+        }
+        else if (a == "--scenario" && i + 1 < argc) {
+            if (!parseScenario(argv[++i], o.scenario)) { err = "unknown scenario " + std::string(argv[i]); return false; }
+            o.fleet = scenarioFleet(o.scenario, o.fleet);
+        }
+        else if (a == "--policy" && i + 1 < argc) {
+            std::string p = argv[++i];
+            if (p == "rr") o.policy = RoundRobin{};
+            else if (p == "lowest") o.policy = LowestBatteryFirst{};
+            else if (p == "weighted") o.policy = BatteryWeighted{};
+            else if (p.compare(0, 3, "drr") == 0) {
+                int q = 1;
+                const char* s = p.c_str() + 3;
+                const char* end = p.c_str() + p.size();
+                if (s < end && (*s++ != ':' || !fleetio::parseInt(s, end, q) || s != end)) {
+                    err = "bad value for --policy"; return false;
+                }
+                o.policy = DeficitRoundRobin(q);
+            }
+            else { err = "bad value for --policy"; return false; }
+        }
+        else if (a == "--csv" && i + 1 < argc) o.csv = argv[++i];
+        else if (a == "--progress" && i + 1 < argc) {
+            char* end = nullptr;
+            o.progress = std::strtod(argv[++i], &end);
+            if (*end || o.progress < 0) { err = "bad value for --progress"; return false; }
+        }
+        else if (a == "--shards") { if (!num(i, 1, v) || v > 1024) { err = "bad value for --shards"; return false; } o.shards = static_cast<std::size_t>(v); }
+        else if (a == "--stats-json" && i + 1 < argc) {
+#ifdef ROBOT_RING_INSTRUMENT
+            o.statsJson = argv[++i];
+#else
+            err = "--stats-json needs a build with -DROBOT_RING_INSTRUMENT"; return false;
+#endif
+        }
+        else if (a == "--help" || a == "-h") { err.clear(); return false; }
+        else { err = "unknown option " + a; return false; }
+    }
+    if (o.scenario != Scenario::None && o.progress > 0) { err = "--progress does not apply to --scenario"; return false; }
+    if (o.shards && (o.scenario != Scenario::None || o.progress > 0 || o.parking || o.verbosity != LogLevel::Off
+                     || !std::holds_alternative<RoundRobin>(o.policy))) {
+        err = "--shards runs round-robin only, without --scenario, --progress, --parking or --verbosity";
+        return false;
+    }
+    return true;
+}
+
+// Build the fleet, run the tick engine flat out, print a throughput summary
+static int runHeadless(HeadlessOptions& o) {
+    using clock = std::chrono::steady_clock;
+    Ring ring;
+    if (o.parking) ring.setScheduleMode(ScheduleMode::Parked);
+    int nextId = 1;
+
+    const auto b0 = clock::now();
+    if (!o.csv.empty()) {
+        FleetLoadResult res = loadFleetCsv(o.csv, ring, nextId, o.quantum);
+        if (!res.ok) { std::cerr << "Import failed: " << res.error << "\n"; return 1; }
+    } else {
+        buildFleet(ring, o.fleet, nextId);
+    }
+    const double buildSecs = std::chrono::duration<double>(clock::now() - b0).count();
+    const std::size_t fleetSize = ring.robotCount();
+
+    ShardCluster<Ring> cluster;             // forked before any thread starts
+    if (o.shards && !cluster.start(ring, o.shards, o.mode)) {
+        std::cerr << "Sharding failed: " << cluster.error() << "\n";
+        return 1;
+    }
+
+    EventLog events(std::cout, o.verbosity);
+    ViewPublisher pub;
+    std::mutex m;
+    std::condition_variable cv;
+    bool finished = false;
+    std::thread monitor;
+    if (o.progress > 0) {
+        // reads published views only, never the live ring
+        monitor = std::thread([&] {
+            const auto period = std::chrono::duration<double>(o.progress);
+            std::unique_lock<std::mutex> lock(m);
+            while (!cv.wait_for(lock, period, [&] { return finished; })) {
+                auto v = pub.current();
+                std::cerr << "[progress] ticks " << v->ticks << "/" << o.turns
+                          << ", robots " << v->robotCount()
+                          << ", avg battery " << v->stats.avgBattery() << "\n";
+            }
+        });
+    }
+
+    const auto t0 = clock::now();
+    TurnStats st;
+    long long rounds = 0;
+    if (o.scenario != Scenario::None) {
+        ScenarioStats sc = runScenario(o.scenario, ring, o.turns, [&](Ring& r, long long k) {
+            return probed(k, o.mode, [&](long long m, long long) { return runScheduled(r, m, events, o.policy, o.mode); });
+        });
+        st = sc.turns;
+        rounds = sc.rounds;
+    } else if (cluster.shards()) {
+        // slices, evening out the shards between them
+        const long long kSlice = std::max(1LL << 20, 16 * static_cast<long long>(fleetSize));
+        while (st.ticks < o.turns) {
+            TurnStats s = cluster.run(std::min(kSlice, o.turns - st.ticks));
+            st += s;
+            if (s.ticks == 0 || (st.ticks < o.turns && !cluster.rebalance())) break;
+        }
+        if (!cluster.gather(ring) || !cluster.error().empty()) {
+            std::cerr << "Sharding failed: " << cluster.error() << "\n";
+            return 1;
+        }
+    } else if (o.progress > 0) {
+        // slices, publishing a view for the monitor about twice per period;
+        // slices scale with the ring so the per-slice O(n) setup stays small
+        const long long kSlice = std::max(1LL << 20, 16 * static_cast<long long>(ring.size()));
+        const auto every = std::chrono::duration<double>(o.progress / 2);
+        auto due = clock::now();
+        pub.publish(ring, 0, 0);
+        while (st.ticks < o.turns) {
+            TurnStats s = probed(std::min(kSlice, o.turns - st.ticks), o.mode, [&](long long k, long long) {
+                return runScheduled(ring, k, events, o.policy, o.mode);
+            });
+            st += s;
+            if (s.ticks == 0) break;
+            if (clock::now() >= due) { pub.publish(ring, st.ticks, st.score); due = clock::now() + std::chrono::duration_cast<clock::duration>(every); }
+        }
+    } else {
+        st = probed(o.turns, o.mode, [&](long long k, long long) {
+            return runScheduled(ring, k, events, o.policy, o.mode);
+        });
+    }
+    events.flush();
+    const double secs = std::chrono::duration<double>(clock::now() - t0).count();
+    if (monitor.joinable()) {
+        { std::lock_guard<std::mutex> lock(m); finished = true; }
+        cv.notify_all();
+        monitor.join();
+    }
+
+    const double rate = secs > 0 ? 1.0 / secs : 0.0;
+    std::cout << "Fleet: " << fleetSize << " robots (built in " << buildSecs * 1000.0 << " ms)\n";
+    std::cout << "Scheduling: " << policyName(o.policy) << "\n";
+    if (o.scenario != Scenario::None) {
+        std::cout << "Scenario: " << scenarioName(o.scenario);
+        if (rounds) std::cout << " (" << rounds << " split/merge rounds)";
+        std::cout << "\n";
+    }
+    if (o.shards) {
+        const ShardStats& sh = cluster.stats();
+        std::cout << "Shards: " << o.shards << " (" << sh.hops << " token hops, " << sh.migrated
+                  << " robots migrated in " << sh.rebalances << " rebalances)\n";
+    }
+    std::cout << "Ran " << st.ticks << " ticks in " << secs << " s: " << st.removed << " removed, "
+              << st.skipped << " skipped\n";
+    std::cout << "Throughput: " << static_cast<long long>(st.ticks * rate) << " ticks/s, "
+              << static_cast<long long>(st.removed * rate) << " removals/s\n";
+    std::cout << "Robots left: " << ring.robotCount() << "\n";
+    std::cout << "Score: " << 2 * static_cast<long long>(fleetSize) + st.score << "\n";
+#ifdef ROBOT_RING_INSTRUMENT
+    instrument::report(std::cout);
+    if (o.statsJson == "-") instrument::dumpJson(std::cout);
+    else if (!o.statsJson.empty()) {
+        std::ofstream out(o.statsJson);
+        instrument::dumpJson(out);
+        if (!out) { std::cerr << "Could not write " << o.statsJson << "\n"; return 1; }
+    }
+#endif
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        HeadlessOptions opt;
+        std::string err;
+        if (!parseHeadless(argc, argv, opt, err)) {
+            if (!err.empty()) std::cerr << err << "\n";
+            headlessUsage(argv[0]);
+            return err.empty() ? 0 : 2;
+        }
+        return runHeadless(opt);
+    }
+
+    Ring ring;                     // main working ring
+    Ring a(ring.get_allocator()), b(ring.get_allocator()); // split/merge; share ring's pool
+    ParallelSim<Ring> sim;         // worker threads for option 13
+    RobotQueue pending;            // robots from producer threads (option 14)
+    EventLog events(std::cout);    // tick lines, formatted off this thread
+    SchedulePolicy policy;         // round-robin until option 16
+    TimerWheel timers;             // scheduled pause/resume/removal (option 17)
+    std::vector<std::thread> producers;
     int nextId = 1;
     long long score = 0;
     long long ticks = 0;
     const int quantum = 1;         // matches sample; used to init Robot::drain
 
     for (;;) {
-        printMenu(ring, score, quantum);
+        printMenu(ring, score, quantum, policy);
         int choice;
         if (!(std::cin >> choice)) break;
 
@@ -130,15 +612,15 @@ int main() {
             addRobot(ring, nextId, score, quantum);
         }
         else if (choice == 2) {
-            score += runOneTurn(ring);
+            joinPending(ring, pending, nextId, score);
+            fireTimers(ring, timers, ticks, events);
+            score += runOneTurn(ring, events, policy);
             ++ticks;
+            fireTimers(ring, timers, ticks, events);
         }
         else if (choice == 3) {
-            int n; std::cout << "Turns: "; std::cin >> n;
-            for (int i = 0; i < n && ring.size() > 0; ++i) {
-                score += runOneTurn(ring);
-                ++ticks;
-            }
+            long long n; std::cout << "Turns: "; std::cin >> n;
+            runManyTurns(ring, n, ticks, score, pending, nextId, events, policy, timers);
         }
         else if (choice == 4) {
             int id; std::cout << "Robot id: "; std::cin >> id;
@@ -163,6 +645,43 @@ int main() {
         else if (choice == 8) {
             statsReport(ring, ticks, score);
         }
+        else if (choice == 9) {
+            // Parked: paused robots leave the rotation and cost no ticks
+            bool park = ring.scheduleMode() == ScheduleMode::Inline;
+            ring.setScheduleMode(park ? ScheduleMode::Parked : ScheduleMode::Inline);
+            std::cout << (park ? "Paused robots will be parked (skips are free).\n"
+                               : "Paused robots stay in the ring (skips use a tick).\n");
+        }
+        else if (choice == 10) {
+            importRobots(ring, nextId, score, quantum);
+        }
+        else if (choice == 11) {
+            saveRing(ring, score, ticks, nextId);
+        }
+        else if (choice == 12) {
+            if (restoreRing(ring, score, ticks, nextId))
+                timers.clear();    // they were keyed on the old tick count
+        }
+        else if (choice == 13) {
+            runParallel(ring, sim, ticks, score);
+        }
+        else if (choice == 14) {
+            startProducer(producers, pending, quantum);
+        }
+        else if (choice == 15) {
+            int level; std::cout << "Log level (0 off, 1 removals, 2 all ticks): "; std::cin >> level;
+            events.setLevel(level <= 0 ? LogLevel::Off : level == 1 ? LogLevel::Removals : LogLevel::All);
+        }
+        else if (choice == 16) {
+            choosePolicy(policy);
+        }
+        else if (choice == 17) {
+            scheduleTimer(timers, ticks);
+        }
+        else if (choice == 18) {
+            int id; std::cout << "Robot id: "; std::cin >> id;
+            retireById(ring, id);
+        }
         else {
             std::cout << "Unknown option.\n";
             // flush bad input if any
@@ -172,5 +691,6 @@ int main() {
             }
         }
     }
+    for (std::thread& t : producers) t.join();
     return 0;
 }
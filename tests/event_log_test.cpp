@@ -0,0 +1,53 @@
+// event_log_test.cpp
+//
+// EventLog must write exactly what formatTurn() writes for the same events,
+// whatever the name length (inline names, names past TurnEvent::kNameBytes,
+// and a slot reused for a short name after a long one).
+//
+// Build and run from this directory:
+//     g++ -std=c++17 -O2 -I.. event_log_test.cpp -o event_log_test -lpthread && ./event_log_test
+// Prints one line per failure and exits non-zero if there was any.
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include "EventLog.h"
+#include "Robot.h"
+#include "Simulation.h"
+
+static int failures = 0;
+
+static void expect(bool ok, const std::string& what) {
+    if (ok) return;
+    std::printf("FAIL: %s\n", what.c_str());
+    ++failures;
+}
+
+int main() {
+    const std::string names[] = {
+        "",
+        "r1",
+        std::string(TurnEvent::kNameBytes, 'a'),
+        std::string(TurnEvent::kNameBytes + 1, 'b'),
+        "robot-with-a-rather-long-name-for-the-dock-" + std::string(300, 'c'),
+        "short",
+    };
+    std::ostringstream logged, expected;
+    {
+        EventLog log(logged, LogLevel::All, 4);     // small: every slot is reused
+        for (int round = 0; round < 3; ++round) {
+            for (const std::string& name : names) {
+                Robot r(1, name, 5, 1, false);
+                for (TurnResult what : {TurnResult::Drained, TurnResult::Skipped, TurnResult::Removed}) {
+                    const int before = what == TurnResult::Skipped ? r.battery : r.battery + 1;
+                    log.record(what, r, before);
+                    formatTurn(expected, what, r, before);
+                }
+            }
+        }
+        log.flush();
+    }
+    expect(logged.str() == expected.str(), "EventLog output differs from formatTurn()");
+    if (failures) return 1;
+    std::printf("ok\n");
+    return 0;
+}
@@ -0,0 +1,120 @@
+// fleet_stats_test.cpp
+//
+// RobotRing::stats() must match a full recount of the robots (rotation and
+// parked) after any mix of ticks, fast-forward jumps, removals, pauses,
+// parking, splits and merges, on every engine.
+//
+// Build and run from this directory:
+//     g++ -std=c++17 -O2 -I.. fleet_stats_test.cpp -o fleet_stats_test && ./fleet_stats_test
+// Prints one line per failure and exits non-zero if there was any.
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "FleetGen.h"
+#include "LinkedList.h"
+#include "RingBuffer.h"
+#include "RobotRing.h"
+#include "Simulation.h"
+#include "UnrolledRing.h"
+
+static int failures = 0;
+
+static void expect(bool ok, const std::string& what) {
+    if (ok) return;
+    std::printf("FAIL: %s\n", what.c_str());
+    ++failures;
+}
+
+template <typename Ring>
+static void check(const Ring& ring, const std::string& what) {
+    long long sum = 0;
+    std::size_t count = 0, paused = 0;
+    int lo = 0, hi = 0;
+    auto add = [&](const Robot& r) {
+        if (!count++) lo = hi = r.battery;
+        lo = std::min(lo, r.battery);
+        hi = std::max(hi, r.battery);
+        sum += r.battery;
+        paused += r.paused;
+    };
+    ring.forEach(add);
+    ring.forEachParked(add);
+    const FleetStats& st = ring.stats();
+    expect(st.count() == count && st.paused() == paused && st.batterySum() == sum
+               && st.minBattery() == lo && st.maxBattery() == hi,
+           what + ": stats differ from a recount");
+}
+
+template <typename Engine>
+static void engineCases(const char* engine) {
+    for (ScheduleMode mode : {ScheduleMode::Inline, ScheduleMode::Parked}) {
+        const std::string tag = std::string(engine) + (mode == ScheduleMode::Parked ? " parked" : " inline");
+        FleetSpec spec;
+        spec.robots = 300;
+        spec.seed = 5;
+        spec.battery = FleetDist::uniform(1, 400);
+        spec.drain = FleetDist::uniform(1, 3);
+        spec.pausedPct = 20;
+        RobotRing<Engine> ring, a, b;
+        ring.setScheduleMode(mode);
+        int nextId = 1;
+        buildFleet(ring, spec, nextId);
+        check(ring, tag + " built");
+        FleetRng rng(11);
+        for (int round = 0; round < 200 && ring.robotCount(); ++round) {
+            switch (rng.next() % 6) {
+            case 0: runTurns(ring, 1 + static_cast<long long>(rng.next() % 500)); break;
+            case 1: runTurns(ring, 1 + static_cast<long long>(rng.next() % 5000), nullptr, TurnMode::FastForward); break;
+            case 2: ring.erase(1 + static_cast<int>(rng.next() % static_cast<std::uint64_t>(nextId))); break;
+            case 3: ring.setPaused(1 + static_cast<int>(rng.next() % static_cast<std::uint64_t>(nextId)), rng.next() % 2 == 0); break;
+            case 4: ring.append(Robot(nextId, "n" + std::to_string(nextId), 1 + static_cast<int>(rng.next() % 900))); ++nextId; break;
+            default:
+                ring.splitIntoTwo(a, b);
+                check(a, tag + " first half");
+                check(b, tag + " second half");
+                ring.mergeWith(a);
+                ring.mergeWith(b);
+            }
+            check(ring, tag + " round " + std::to_string(round));
+        }
+    }
+}
+
+// A merge must not lose a robot: one whose id is in both rings (here parked
+// in both) is refused with both rings left as they were, and split targets
+// drop what they held before
+static void mergeCases() {
+    RobotRing<> a, b, first, second;
+    for (RobotRing<>* r : {&a, &b, &first}) r->setScheduleMode(ScheduleMode::Parked);
+    a.append(Robot(1, "a1", 10));
+    a.append(Robot(7, "a7", 20, 1, true));
+    b.append(Robot(7, "b7", 30, 1, true));
+    b.append(Robot(8, "b8", 40));
+    a.settleFront(); a.rotate(); a.settleFront();
+    b.settleFront();
+    expect(a.parkedCount() == 1 && b.parkedCount() == 1, "merge setup");
+    expect(!a.mergeWith(b), "merge with a shared parked id accepted");
+    expect(a.robotCount() == 2 && b.robotCount() == 2, "refused merge moved robots");
+    check(a, "refused merge, target");
+    check(b, "refused merge, source");
+    b.erase(7);
+    expect(a.mergeWith(b) && a.robotCount() == 3 && b.robotCount() == 0, "merge without shared ids refused");
+    check(a, "merge");
+
+    first.append(Robot(50, "old", 5, 1, true));
+    first.settleFront();
+    a.splitIntoTwo(first, second);
+    expect(!first.find(50) && first.robotCount() + second.robotCount() == 3, "split kept a target's old robots");
+    check(first, "split target");
+}
+
+int main() {
+    mergeCases();
+    engineCases<LinkedList<Robot>>("LinkedList");
+    engineCases<RingBuffer<Robot>>("RingBuffer");
+    engineCases<UnrolledRing<Robot>>("UnrolledRing");
+    if (failures) return 1;
+    std::printf("ok\n");
+    return 0;
+}
@@ -0,0 +1,69 @@
+// snapshot_test.cpp
+//
+// decodeSnapshot must restore what encodeSnapshot wrote, and must reject a
+// snapshot with a repeated robot id or a name reference out of bounds while
+// leaving the target ring as it was. A stale nextId is raised past the
+// largest robot id.
+//
+// Build and run from this directory:
+//     g++ -std=c++17 -O2 -I.. snapshot_test.cpp -o snapshot_test && ./snapshot_test
+// Prints one line per failure and exits non-zero if there was any.
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include "LinkedList.h"
+#include "RobotRing.h"
+#include "Snapshot.h"
+
+static int failures = 0;
+
+static void expect(bool ok, const std::string& what) {
+    if (ok) return;
+    std::printf("FAIL: %s\n", what.c_str());
+    ++failures;
+}
+
+// The i-th record of encoded bytes, to patch in place
+static void patchRecord(std::string& bytes, std::size_t i, void (*edit)(SnapshotRecord&)) {
+    char* at = &bytes[sizeof(SnapshotHeader) + i * sizeof(SnapshotRecord)];
+    SnapshotRecord r;
+    std::memcpy(&r, at, sizeof r);
+    edit(r);
+    std::memcpy(at, &r, sizeof r);
+}
+
+int main() {
+    RobotRing<> ring;
+    for (int i = 1; i <= 5; ++i) ring.append(Robot(i, "robot-" + std::to_string(i), 100 * i, i));
+    SnapshotCounters c;
+    c.score = 7; c.ticks = 11; c.nextId = 6;
+    const std::string bytes = encodeSnapshot(ring, c);
+
+    RobotRing<> back;
+    SnapshotCounters bc;
+    SnapshotResult res = decodeSnapshot(bytes, back, bc);
+    expect(res.ok && res.robots == 5, "round trip: " + res.error);
+    expect(encodeSnapshot(back, bc) == bytes, "round trip changed the snapshot");
+
+    std::string dup = bytes;
+    patchRecord(dup, 3, [](SnapshotRecord& r) { r.id = 2; });
+    RobotRing<> target;
+    target.append(Robot(99, "kept", 1));
+    res = decodeSnapshot(dup, target, bc);
+    expect(!res.ok && res.error == "duplicate robot id 2", "duplicate id accepted: " + res.error);
+    expect(target.size() == 1 && target.find(99), "rejected snapshot changed the ring");
+
+    std::string badName = bytes;
+    patchRecord(badName, 4, [](SnapshotRecord& r) { r.nameOffset = 0xFFFFFFF0u; });
+    res = decodeSnapshot(badName, target, bc);
+    expect(!res.ok && res.error == "corrupt name reference", "bad name reference accepted: " + res.error);
+
+    SnapshotCounters stale = c;
+    stale.nextId = 3;                   // below robots 3..5
+    res = decodeSnapshot(encodeSnapshot(ring, stale), back, bc);
+    expect(res.ok && bc.nextId == 6, "stale nextId kept: " + std::to_string(bc.nextId));
+
+    if (failures) return 1;
+    std::printf("ok\n");
+    return 0;
+}
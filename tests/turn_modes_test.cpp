@@ -0,0 +1,112 @@
+// turn_modes_test.cpp
+//
+// TurnMode::Step and TurnMode::FastForward must leave a ring in the same
+// state (robots, order, batteries, parked table) with the same totals, in
+// both schedule modes and on every engine. Deficit round-robin must not
+// spend ticks on paused robots in ScheduleMode::Parked.
+//
+// Build and run from this directory:
+//     g++ -std=c++17 -O2 -I.. turn_modes_test.cpp -o turn_modes_test && ./turn_modes_test
+// Prints one line per failure and exits non-zero if there was any.
+#include <cstdio>
+#include <string>
+#include "FleetGen.h"
+#include "LinkedList.h"
+#include "RingBuffer.h"
+#include "RobotRing.h"
+#include "Scheduler.h"
+#include "Simulation.h"
+#include "Snapshot.h"
+#include "UnrolledRing.h"
+
+static int failures = 0;
+
+static void expect(bool ok, const std::string& what) {
+    if (ok) return;
+    std::printf("FAIL: %s\n", what.c_str());
+    ++failures;
+}
+
+template <typename Ring>
+static void build(Ring& ring, const FleetSpec& spec, ScheduleMode mode) {
+    ring.setScheduleMode(mode);
+    int nextId = 1;
+    buildFleet(ring, spec, nextId);
+}
+
+template <typename Engine>
+static void compareModes(const char* engine, const FleetSpec& spec, ScheduleMode mode, long long n,
+                         const std::string& label) {
+    RobotRing<Engine> step, fast;
+    build(step, spec, mode);
+    build(fast, spec, mode);
+    TurnStats a = runTurns(step, n, nullptr, TurnMode::Step);
+    TurnStats b = runTurns(fast, n, nullptr, TurnMode::FastForward);
+    const std::string what = label + (mode == ScheduleMode::Parked ? " parked " : " inline ") + engine;
+    expect(a.ticks == b.ticks && a.score == b.score && a.removed == b.removed && a.skipped == b.skipped,
+           what + ": totals differ");
+    expect(step.size() == fast.size() && step.parkedCount() == fast.parkedCount(), what + ": sizes differ");
+    expect(encodeSnapshot(step, SnapshotCounters()) == encodeSnapshot(fast, SnapshotCounters()),
+           what + ": ring state differs");
+}
+
+template <typename Engine>
+static void engineCases(const char* engine) {
+    for (ScheduleMode mode : {ScheduleMode::Inline, ScheduleMode::Parked}) {
+        // 8 robots, every third paused, long lives: whole SoA laps
+        RobotRing<Engine> small;
+        small.setScheduleMode(mode);
+        for (int i = 0; i < 8; ++i) small.append(Robot(i + 1, "r" + std::to_string(i + 1), 1000, 1, i % 3 == 0));
+        RobotRing<Engine> smallFast;
+        smallFast.setScheduleMode(mode);
+        small.forEach([&](const Robot& r) { smallFast.append(r); });
+        TurnStats a = runTurns(small, 100, nullptr, TurnMode::Step);
+        TurnStats b = runTurns(smallFast, 100, nullptr, TurnMode::FastForward);
+        const std::string what = std::string("every third paused") + (mode == ScheduleMode::Parked ? " parked " : " inline ") + engine;
+        expect(a.ticks == b.ticks && a.score == b.score && a.skipped == b.skipped, what + ": totals differ");
+        expect(encodeSnapshot(small, SnapshotCounters()) == encodeSnapshot(smallFast, SnapshotCounters()),
+               what + ": ring state differs");
+
+        for (std::uint64_t seed = 1; seed <= 4; ++seed) {
+            FleetSpec spec;
+            spec.robots = 500;
+            spec.seed = seed;
+            spec.battery = FleetDist::zipf(1, 2000);
+            spec.drain = seed % 2 ? FleetDist::uniform(1, 1) : FleetDist::uniform(1, 3);
+            spec.pausedPct = static_cast<int>(seed * 10);
+            compareModes<Engine>(engine, spec, mode, 20000 + static_cast<long long>(seed) * 7919,
+                                 "seed " + std::to_string(seed));
+        }
+    }
+}
+
+// Robot 1 needs two rounds of credit, so the policy rotates on to the
+// paused robot 2 before anything runs: parked, it must cost no tick
+static void deficitCases() {
+    for (ScheduleMode mode : {ScheduleMode::Inline, ScheduleMode::Parked}) {
+        RobotRing<> ring;
+        ring.setScheduleMode(mode);
+        ring.append(Robot(1, "r1", 100, 2));
+        ring.append(Robot(2, "r2", 100, 1, true));
+        ring.append(Robot(3, "r3", 100, 1));
+        SchedulePolicy policy = DeficitRoundRobin(1);
+        StreamSink sink;
+        TurnStats st = runScheduled(ring, 30, sink, policy);
+        const std::string what = std::string("deficit round-robin") + (mode == ScheduleMode::Parked ? " parked" : " inline");
+        if (mode == ScheduleMode::Parked)
+            expect(st.skipped == 0 && ring.parkedCount() == 1, what + ": ticks spent on a paused robot");
+        else
+            expect(st.skipped > 0, what + ": paused robot not skipped");
+        expect(st.ticks == 30, what + ": ran short");
+    }
+}
+
+int main() {
+    deficitCases();
+    engineCases<LinkedList<Robot>>("LinkedList");
+    engineCases<RingBuffer<Robot>>("RingBuffer");
+    engineCases<UnrolledRing<Robot>>("UnrolledRing");
+    if (failures) return 1;
+    std::printf("ok\n");
+    return 0;
+}